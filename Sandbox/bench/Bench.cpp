@@ -0,0 +1,470 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <Core/Memory.h>
+#include <Core/Time.h>
+
+#include <Math/Math.h>
+#include <Math/MatrixTransform.h>
+
+#include <Resource/ResourceManager.h>
+#include <Renderer/Material.h>
+
+#include "ECS/Scene.h"
+#include "ECS/Components/Components.h"
+#include "ECS/Components/RenderableComponents.h"
+
+#include "SceneGraph/SceneGraph.h"
+#include "Physics/Physics3D.h"
+#include "ParticleSystem/Particles.h"
+#include "RenderScene/RenderScene.h"
+#include "RenderScene/RenderPipeline.h"
+#include "Scripts/NativeScript.h"
+#include "Scripts/Turret.h"
+#include "Scripts/VillageManager.h"
+
+#include "Jobs/JobSystem.h"
+#include "Jobs/TaskGraph.h"
+
+#include "GameLevel.h"
+#include "GameTasks.h"
+#include "BenchProfiler.h"
+
+struct BenchSettings
+{
+	int frames = 600;
+	int warmup_frames = 60;
+
+	int villagers = 100;
+	int enemies = 0; // Spawned as one prefab wave before the first frame
+
+	int turrets = 4;
+	int turret_wave_frames = 300; // Frames between turret waves, turrets despawn after 5s
+
+	float dt = 1.0f / 60.0f;
+
+	int access_iterations = 100; // Passes of the component access comparison, 0 to skip
+	int snapshot_iterations = 100; // Scene snapshot and restore round trips, 0 to skip
+	int storage_iterations = 20; // Spawn and query rounds of the storage comparison, 0 to skip
+
+	SceneStorage storage = DEFAULT_SCENE_STORAGE; // Storage of the simulated scene
+	RenderPipelineMode render_pipeline = RenderPipelineMode::Synchronous; // Same as GameLayer
+	bool batching = false; // Sorts the visible mesh objects into instanced batches, off in GameLayer
+
+	const char* write_level_snapshot = nullptr; // Bakes the game level snapshot to this path and exits
+};
+
+static void PrintUsage()
+{
+	printf("usage: CapitalPunishmentBench [--frames N] [--warmup N] [--villagers N] [--enemies N] [--turrets N] [--turret-wave-frames N] [--dt seconds] [--access-iterations N] [--snapshot-iterations N] [--storage-iterations N] [--storage sparse|packed] [--render-pipeline sync|pipelined] [--batching on|off] [--write-level-snapshot path]\n");
+}
+
+static bool ParseSettings(int argc, char** argv, BenchSettings& settings)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--help") == 0)
+		{
+			return false;
+		}
+
+		if (!value)
+		{
+			fprintf(stderr, "Missing value for %s\n", arg);
+			return false;
+		}
+
+		if (strcmp(arg, "--frames") == 0) { settings.frames = atoi(value); }
+		else if (strcmp(arg, "--warmup") == 0) { settings.warmup_frames = atoi(value); }
+		else if (strcmp(arg, "--villagers") == 0) { settings.villagers = atoi(value); }
+		else if (strcmp(arg, "--enemies") == 0) { settings.enemies = atoi(value); }
+		else if (strcmp(arg, "--turrets") == 0) { settings.turrets = atoi(value); }
+		else if (strcmp(arg, "--turret-wave-frames") == 0) { settings.turret_wave_frames = atoi(value); }
+		else if (strcmp(arg, "--dt") == 0) { settings.dt = static_cast<float>(atof(value)); }
+		else if (strcmp(arg, "--access-iterations") == 0) { settings.access_iterations = atoi(value); }
+		else if (strcmp(arg, "--snapshot-iterations") == 0) { settings.snapshot_iterations = atoi(value); }
+		else if (strcmp(arg, "--storage-iterations") == 0) { settings.storage_iterations = atoi(value); }
+		else if (strcmp(arg, "--storage") == 0)
+		{
+			if (strcmp(value, "sparse") == 0) { settings.storage = SceneStorage::Sparse; }
+			else if (strcmp(value, "packed") == 0) { settings.storage = SceneStorage::Packed; }
+			else
+			{
+				fprintf(stderr, "Unknown storage %s\n", value);
+				return false;
+			}
+		}
+		else if (strcmp(arg, "--render-pipeline") == 0)
+		{
+			if (strcmp(value, "sync") == 0) { settings.render_pipeline = RenderPipelineMode::Synchronous; }
+			else if (strcmp(value, "pipelined") == 0) { settings.render_pipeline = RenderPipelineMode::Pipelined; }
+			else
+			{
+				fprintf(stderr, "Unknown render pipeline %s\n", value);
+				return false;
+			}
+		}
+		else if (strcmp(arg, "--batching") == 0)
+		{
+			if (strcmp(value, "on") == 0) { settings.batching = true; }
+			else if (strcmp(value, "off") == 0) { settings.batching = false; }
+			else
+			{
+				fprintf(stderr, "Unknown batching %s\n", value);
+				return false;
+			}
+		}
+		else if (strcmp(arg, "--write-level-snapshot") == 0) { settings.write_level_snapshot = value; }
+		else
+		{
+			fprintf(stderr, "Unknown argument %s\n", arg);
+			return false;
+		}
+
+		i++;
+	}
+
+	return settings.frames > 0 && settings.turret_wave_frames > 0 && settings.dt > 0.0f;
+}
+
+// Same setup as UnitController::AltAttack without the launch impulse
+static void SpawnTurret(Scene* scene, const yoyo::Vec3& position)
+{
+	yoyo::Mat4x4 transform_matrix = yoyo::TranslationMat4x4(position) * yoyo::ScaleMat4x4({ 1.0f, 1.0f, 1.0f });
+
+	Entity turret = scene->Instantiate("Turret", transform_matrix);
+	MeshRendererComponent& mesh_renderer = turret.AddComponent<MeshRendererComponent>();
+	mesh_renderer.SetMesh(yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>("Cube"));
+	mesh_renderer.SetMaterial(yoyo::ResourceManager::Instance().Load<yoyo::Material>("grenade_instanced_material"));
+
+	psx::RigidBodyComponent& rb = turret.AddComponent<psx::RigidBodyComponent>();
+	rb.LockRotationAxis({ 0, 1, 0 });
+	turret.AddComponent<psx::BoxColliderComponent>();
+
+	turret.AddComponent<Turret>(turret);
+}
+
+// Spreads n entities over a square grid centered on the origin
+static yoyo::Vec3 GridPosition(int index, int count, float spacing)
+{
+	int side = 1;
+	while (side * side < count)
+	{
+		side++;
+	}
+
+	float offset = (side - 1) * spacing * 0.5f;
+	return { (index % side) * spacing - offset, 0.0f, (index / side) * spacing - offset };
+}
+
+// Mesh sync as it was written per entity against Scene::Each
+static void BenchComponentAccess(Scene* scene, int iterations)
+{
+	double entity_time = 0.0;
+	{
+		yoyo::ScopedTimer entity_timer([&](const yoyo::ScopedTimer& timer) { entity_time = timer.delta; });
+		for (int i = 0; i < iterations; i++)
+		{
+			for (auto& id : scene->Registry().view<TransformComponent, MeshRendererComponent>())
+			{
+				Entity e{ id, scene };
+				MeshRendererComponent& mesh_renderer = e.GetComponent<MeshRendererComponent>();
+				mesh_renderer.mesh_object->model_matrix = e.GetComponent<TransformComponent>().model_matrix;
+			}
+		}
+	}
+
+	double each_time = 0.0;
+	{
+		yoyo::ScopedTimer each_timer([&](const yoyo::ScopedTimer& timer) { each_time = timer.delta; });
+		for (int i = 0; i < iterations; i++)
+		{
+			scene->Each<TransformComponent, MeshRendererComponent>([](const TransformComponent& transform, MeshRendererComponent& mesh_renderer) {
+				mesh_renderer.mesh_object->model_matrix = transform.model_matrix;
+			});
+		}
+	}
+
+	printf("component access (%d passes over %zu meshes): Entity %.3fms, Each %.3fms\n", iterations,
+		scene->Registry().view<TransformComponent, MeshRendererComponent>().size_hint(), entity_time * 1000.0, each_time * 1000.0);
+}
+
+static void BenchSnapshot(Scene* scene, int iterations)
+{
+	// The first snapshot grows the state's buffers, later ones reuse them
+	SceneState state;
+	scene->Snapshot(state);
+
+	double snapshot_time = 0.0;
+	double restore_time = 0.0;
+	for (int i = 0; i < iterations; i++)
+	{
+		{
+			yoyo::ScopedTimer snapshot_timer([&](const yoyo::ScopedTimer& timer) { snapshot_time += timer.delta; });
+			scene->Snapshot(state);
+		}
+
+		{
+			yoyo::ScopedTimer restore_timer([&](const yoyo::ScopedTimer& timer) { restore_time += timer.delta; });
+			scene->Restore(state);
+		}
+	}
+
+	printf("scene snapshot (%zu entities): snapshot %.3fms, restore %.3fms\n", scene->Registry().view<TransformComponent>().size_hint(),
+		snapshot_time * 1000.0 / iterations, restore_time * 1000.0 / iterations);
+}
+
+static const char* StorageName(SceneStorage storage)
+{
+	return storage == SceneStorage::Packed ? "packed" : "sparse";
+}
+
+static const char* PipelineName(RenderPipelineMode mode)
+{
+	return mode == RenderPipelineMode::Pipelined ? "pipelined" : "sync";
+}
+
+// Spawns waves of meshes among transform only entities, destroys every other wave and syncs the meshes after each wave
+static void BenchStorage(SceneStorage storage, int iterations)
+{
+	const int waves = 16;
+	const int wave_size = 1024;
+
+	double spawn_time = 0.0;
+	double query_time = 0.0;
+	size_t synced = 0;
+	for (int i = 0; i < iterations; i++)
+	{
+		Scene scene(storage);
+		scene.Pack<TransformComponent, MeshRendererComponent>();
+
+		std::vector<Entity> wave;
+		wave.reserve(wave_size);
+		for (int w = 0; w < waves; w++)
+		{
+			{
+				yoyo::ScopedTimer spawn_timer([&](const yoyo::ScopedTimer& timer) { spawn_time += timer.delta; });
+
+				wave.clear();
+				for (int n = 0; n < wave_size; n++)
+				{
+					Entity e = scene.Instantiate("Spawned", GridPosition(n, wave_size, 2.0f));
+					if (n % 2 == 0)
+					{
+						e.AddComponent<MeshRendererComponent>();
+					}
+					wave.push_back(e);
+				}
+
+				if (w % 2 == 1)
+				{
+					for (Entity e : wave)
+					{
+						scene.Destroy(e);
+					}
+				}
+			}
+
+			{
+				yoyo::ScopedTimer query_timer([&](const yoyo::ScopedTimer& timer) { query_time += timer.delta; });
+				scene.Each<TransformComponent, MeshRendererComponent>([&](const TransformComponent& transform, MeshRendererComponent& mesh_renderer) {
+					mesh_renderer.mesh_object->model_matrix = transform.model_matrix;
+					synced++;
+				});
+			}
+		}
+	}
+
+	printf("%s storage (%d rounds of %d waves of %d): spawn %.3fms, query %.3fms, %zu meshes synced\n", StorageName(storage), iterations, waves, wave_size,
+		spawn_time * 1000.0 / iterations, query_time * 1000.0 / iterations, synced);
+}
+
+int main(int argc, char** argv)
+{
+	BenchSettings settings = {};
+	if (!ParseSettings(argc, argv, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	// Systems are created and initialized in the same order as GameLayer without a renderer
+	Scene* scene = YNEW Scene(settings.storage);
+
+	Ref<SceneGraph> scene_graph = CreateRef<SceneGraph>(scene);
+	Ref<psx::PhysicsWorld> physics_world = CreateRef<psx::PhysicsWorld>(scene);
+	Ref<ScriptingSystem> scripting = CreateRef<ScriptingSystem>(scene, physics_world.get());
+
+	// Packets are dropped once submitted
+	Ref<RenderPipeline> render_pipeline = CreateRef<RenderPipeline>(nullptr, settings.render_pipeline);
+
+	Ref<RenderSceneSystem> render_scene = CreateRef<RenderSceneSystem>(scene, render_pipeline.get());
+	render_scene->Init();
+	render_scene->SetBatching(settings.batching);
+
+	Ref<ParticleSystemManager> particles = CreateRef<ParticleSystemManager>(scene, render_pipeline.get());
+	particles->Init();
+
+	scene_graph->Init();
+	physics_world->Init();
+	scripting->Init();
+
+	GameSystems systems = {};
+	systems.scene = scene;
+	systems.scene_graph = scene_graph.get();
+	systems.physics_world = physics_world.get();
+	systems.scripting = scripting.get();
+	systems.particles = particles.get();
+	systems.render_scene = render_scene.get();
+
+	// Same schedule as GameLayer::OnUpdate
+	TaskGraph task_graph;
+	BuildGameTaskGraph(task_graph, systems);
+
+	LoadGameAssets();
+	if (settings.write_level_snapshot)
+	{
+		bool saved = WriteGameLevelSnapshot(scene, settings.write_level_snapshot);
+		printf("level snapshot %s %s\n", saved ? "written to" : "could not be written to", settings.write_level_snapshot);
+
+		particles->Shutdown();
+		scripting->Shutdown();
+		physics_world->Shutdown();
+		scene_graph->Shutdown();
+		render_scene->Shutdown();
+
+		YDELETE scene;
+		return saved ? 0 : 1;
+	}
+
+	{
+		bool from_snapshot = false;
+		yoyo::ScopedTimer level_timer([&](const yoyo::ScopedTimer& timer) {
+			printf("level %s in %.3fms\n", from_snapshot ? "loaded from snapshot" : "built", timer.delta * 1000.0f);
+		});
+		from_snapshot = LoadGameLevel(scene);
+	}
+
+	// Village manager only spawns on request
+	Entity village_manager = scene->Instantiate("village_manager", { 0.0f, 0.0f, 0.0f });
+	VillageProps& village_props = village_manager.AddComponent<VillageProps>();
+	village_props.max_villagers = 0;
+	village_props.spawn_rate = 1.0f;
+
+	VillageManagerComponent& village = village_manager.AddComponent<VillageManagerComponent>(village_manager);
+	for (int i = 0; i < settings.villagers; i++)
+	{
+		VillagerProps props = {};
+		props.position = GridPosition(i, settings.villagers, 4.0f);
+		village.SpawnVillager(props);
+	}
+
+	// Spawns are recorded on the command buffer
+	scene->FlushCommandBuffers();
+
+	if (settings.enemies > 0)
+	{
+		yoyo::ScopedTimer spawn_timer([&](const yoyo::ScopedTimer& timer) {
+			printf("spawned %d enemies in %.3fms\n", settings.enemies, timer.delta * 1000.0f);
+		});
+		village.SpawnEnemies(settings.enemies);
+		scene->FlushCommandBuffers();
+	}
+
+	printf("CapitalPunishmentBench: %d frames (%d warm up), %d villagers, %d enemies, %d turrets every %d frames, dt %.4fs, %s storage, %s render pipeline\n",
+		settings.frames, settings.warmup_frames, settings.villagers, settings.enemies, settings.turrets, settings.turret_wave_frames, settings.dt, StorageName(settings.storage),
+		PipelineName(settings.render_pipeline));
+	printf("sizeof(TransformComponent): %zu bytes\n", sizeof(TransformComponent));
+
+	if (settings.access_iterations > 0)
+	{
+		BenchComponentAccess(scene, settings.access_iterations);
+	}
+
+	if (settings.snapshot_iterations > 0)
+	{
+		BenchSnapshot(scene, settings.snapshot_iterations);
+	}
+
+	if (settings.storage_iterations > 0)
+	{
+		BenchStorage(SceneStorage::Sparse, settings.storage_iterations);
+		BenchStorage(SceneStorage::Packed, settings.storage_iterations);
+	}
+	printf("job system workers: %u\n", JobSystem::Instance().WorkerCount());
+
+	BenchProfiler profiler;
+	const float dt = settings.dt;
+
+	for (int frame = 0; frame < settings.warmup_frames + settings.frames; frame++)
+	{
+		if (frame == settings.warmup_frames)
+		{
+			profiler.Clear();
+			render_pipeline->ClearStats();
+		}
+
+		if (settings.turrets > 0 && frame % settings.turret_wave_frames == 0)
+		{
+			for (int i = 0; i < settings.turrets; i++)
+			{
+				yoyo::Vec3 position = GridPosition(i, settings.turrets, 24.0f);
+				position.y = 1.0f;
+				SpawnTurret(scene, position);
+			}
+		}
+
+		{
+			yoyo::ScopedTimer frame_timer([&](const yoyo::ScopedTimer& timer) {
+				profiler.Record("Frame", timer.delta);
+			});
+			render_pipeline->BeginFrame();
+			task_graph.Run(dt);
+			render_pipeline->EndFrame();
+		}
+
+		profiler.Record("Render Submit", render_pipeline->Stats().submit_time);
+		profiler.Record("Render Submit Wait", render_pipeline->Stats().wait_time);
+
+		for (const TaskGraph::Task& task : task_graph.Tasks())
+		{
+			profiler.Record(task.name, task.time);
+		}
+	}
+
+	profiler.Report(stdout);
+	printf("entities alive: %zu\n", scene->Registry().view<TransformComponent>().size());
+
+	const RenderPipelineStats& pipeline_stats = render_pipeline->Stats();
+	printf("render pipeline: %llu frames submitted, latency %.3fms average, %.3fms last frame\n", static_cast<unsigned long long>(pipeline_stats.frames),
+		pipeline_stats.average_latency * 1000.0f, pipeline_stats.latency * 1000.0f);
+
+	const CullStats& culling = render_scene->Culling();
+	printf("culling (last frame): %u mesh objects tested, %u visible, %u culled, %u of them kept as shadow casters\n", culling.tested, culling.visible, culling.culled,
+		culling.shadow_casters);
+
+	if (settings.batching)
+	{
+		const BatchStats& batching = render_scene->Batching();
+		printf("batching (last frame): %u mesh objects in %u instanced batches, %.1f per batch, %u in the largest\n", batching.objects, batching.batches,
+			batching.ObjectsPerBatch(), batching.largest);
+	}
+
+	const LodStats& lods = render_scene->Lods();
+	printf("levels of detail (last frame): %u mesh objects at levels %u/%u/%u/%u, %llu indices drawn of %llu at full detail, %.1fx fewer\n", lods.objects,
+		lods.levels[0], lods.levels[1], lods.levels[2], lods.levels[3], static_cast<unsigned long long>(lods.indices), static_cast<unsigned long long>(lods.full_detail_indices),
+		lods.Reduction());
+
+	particles->Shutdown();
+	scripting->Shutdown();
+	physics_world->Shutdown();
+	scene_graph->Shutdown();
+	render_scene->Shutdown();
+
+	YDELETE scene;
+	return 0;
+}
@@ -0,0 +1,59 @@
+#include "BenchProfiler.h"
+
+#include <algorithm>
+#include <numeric>
+
+// Nearest rank percentile of sorted samples
+static float Percentile(const std::vector<float>& sorted, float percentile)
+{
+	if (sorted.empty())
+	{
+		return 0.0f;
+	}
+
+	size_t rank = static_cast<size_t>(percentile * static_cast<float>(sorted.size() - 1) + 0.5f);
+	return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void BenchProfiler::Record(const std::string& key, float seconds)
+{
+	auto it = m_indices.find(key);
+	if (it == m_indices.end())
+	{
+		it = m_indices.emplace(key, m_samples.size()).first;
+		m_samples.push_back({ key, {} });
+	}
+
+	m_samples[it->second].values.push_back(seconds);
+}
+
+void BenchProfiler::Clear()
+{
+	for (Samples& samples : m_samples)
+	{
+		samples.values.clear();
+	}
+}
+
+void BenchProfiler::Report(FILE* out) const
+{
+	fprintf(out, "%-28s %8s %10s %10s %10s %10s %10s\n", "key", "frames", "mean(ms)", "p50(ms)", "p95(ms)", "p99(ms)", "max(ms)");
+
+	for (const Samples& samples : m_samples)
+	{
+		std::vector<float> sorted = samples.values;
+		std::sort(sorted.begin(), sorted.end());
+
+		float mean = sorted.empty() ? 0.0f : std::accumulate(sorted.begin(), sorted.end(), 0.0f) / static_cast<float>(sorted.size());
+		float max = sorted.empty() ? 0.0f : sorted.back();
+
+		fprintf(out, "%-28s %8zu %10.4f %10.4f %10.4f %10.4f %10.4f\n",
+			samples.key.c_str(),
+			sorted.size(),
+			mean * 1000.0f,
+			Percentile(sorted, 0.50f) * 1000.0f,
+			Percentile(sorted, 0.95f) * 1000.0f,
+			Percentile(sorted, 0.99f) * 1000.0f,
+			max * 1000.0f);
+	}
+}
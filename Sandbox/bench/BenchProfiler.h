@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Collects per frame samples under GameLayer profile keys and reports their distribution
+class BenchProfiler
+{
+public:
+    BenchProfiler() = default;
+    ~BenchProfiler() = default;
+
+    // Records a sample in seconds, as reported by yoyo::ScopedTimer::delta
+    void Record(const std::string& key, float seconds);
+
+    // Drops all samples recorded so far, i.e. after warm up frames
+    void Clear();
+
+    // Writes count, mean, p50, p95, p99 and max in milliseconds for each key
+    void Report(FILE* out) const;
+private:
+    struct Samples
+    {
+        std::string key;
+        std::vector<float> values;
+    };
+
+    // Keys are reported in the order they were first recorded
+    std::vector<Samples> m_samples;
+    std::unordered_map<std::string, size_t> m_indices;
+};
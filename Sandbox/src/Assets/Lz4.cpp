@@ -0,0 +1,193 @@
+#include "Lz4.h"
+
+#include <cstring>
+
+// Block format limits, the last match starts 12 bytes before the end and the last 5 bytes are literals
+static constexpr size_t LZ4_MIN_MATCH = 4;
+static constexpr size_t LZ4_MATCH_START_LIMIT = 12;
+static constexpr size_t LZ4_LAST_LITERALS = 5;
+static constexpr size_t LZ4_MAX_OFFSET = 65535;
+
+static constexpr uint32_t LZ4_HASH_BITS = 16;
+
+static uint32_t Read32(const uint8_t* p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+// Length fields continue in bytes of 255 once their nibble is saturated
+static bool ReadLength(const uint8_t*& ip, const uint8_t* iend, size_t& length)
+{
+	uint8_t byte;
+	do
+	{
+		if (ip >= iend)
+		{
+			return false;
+		}
+
+		byte = *ip++;
+		length += byte;
+	} while (byte == 255);
+
+	return true;
+}
+
+static void WriteLength(std::vector<uint8_t>& out, size_t length)
+{
+	for (; length >= 255; length -= 255)
+	{
+		out.push_back(255);
+	}
+
+	out.push_back(static_cast<uint8_t>(length));
+}
+
+bool Lz4Decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size)
+{
+	const uint8_t* ip = src;
+	const uint8_t* iend = src + src_size;
+	uint8_t* op = dst;
+	uint8_t* oend = dst + dst_size;
+
+	while (ip < iend)
+	{
+		const uint8_t token = *ip++;
+
+		size_t literals = token >> 4;
+		if (literals == 15 && !ReadLength(ip, iend, literals))
+		{
+			return false;
+		}
+
+		if (literals > static_cast<size_t>(iend - ip) || literals > static_cast<size_t>(oend - op))
+		{
+			return false;
+		}
+
+		memcpy(op, ip, literals);
+		ip += literals;
+		op += literals;
+
+		// The last sequence has no match
+		if (ip == iend)
+		{
+			break;
+		}
+
+		if (iend - ip < 2)
+		{
+			return false;
+		}
+
+		const size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		if (offset == 0 || offset > static_cast<size_t>(op - dst))
+		{
+			return false;
+		}
+
+		size_t match = token & 15;
+		if (match == 15 && !ReadLength(ip, iend, match))
+		{
+			return false;
+		}
+
+		match += LZ4_MIN_MATCH;
+		if (match > static_cast<size_t>(oend - op))
+		{
+			return false;
+		}
+
+		// Matches may overlap the bytes they produce
+		const uint8_t* from = op - offset;
+		for (size_t i = 0; i < match; i++)
+		{
+			op[i] = from[i];
+		}
+
+		op += match;
+	}
+
+	return op == oend;
+}
+
+static void WriteSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literal_count, size_t offset, size_t match)
+{
+	const bool has_match = match > 0;
+	const size_t match_code = has_match ? match - LZ4_MIN_MATCH : 0;
+
+	out.push_back(static_cast<uint8_t>(((literal_count < 15 ? literal_count : 15) << 4) | (match_code < 15 ? match_code : 15)));
+	if (literal_count >= 15)
+	{
+		WriteLength(out, literal_count - 15);
+	}
+
+	out.insert(out.end(), literals, literals + literal_count);
+
+	if (!has_match)
+	{
+		return;
+	}
+
+	out.push_back(static_cast<uint8_t>(offset & 0xff));
+	out.push_back(static_cast<uint8_t>(offset >> 8));
+	if (match_code >= 15)
+	{
+		WriteLength(out, match_code - 15);
+	}
+}
+
+std::vector<uint8_t> Lz4Compress(const uint8_t* src, size_t size)
+{
+	std::vector<uint8_t> out;
+	out.reserve(size + size / 255 + 16);
+
+	// Positions + 1 of the last 4 byte sequence with each hash, 0 when empty
+	std::vector<uint32_t> table(size_t(1) << LZ4_HASH_BITS, 0);
+
+	size_t anchor = 0;
+	size_t i = 0;
+	const size_t match_end_limit = size > LZ4_LAST_LITERALS ? size - LZ4_LAST_LITERALS : 0;
+
+	while (i + LZ4_MATCH_START_LIMIT <= size)
+	{
+		const uint32_t sequence = Read32(src + i);
+		const uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+
+		const size_t candidate = table[hash];
+		table[hash] = static_cast<uint32_t>(i + 1);
+
+		if (candidate == 0 || i - (candidate - 1) > LZ4_MAX_OFFSET || Read32(src + candidate - 1) != sequence)
+		{
+			i++;
+			continue;
+		}
+
+		size_t reference = candidate - 1;
+
+		// Pull the start of the match into the pending literals
+		while (i > anchor && reference > 0 && src[i - 1] == src[reference - 1])
+		{
+			i--;
+			reference--;
+		}
+
+		size_t match = LZ4_MIN_MATCH;
+		while (i + match < match_end_limit && src[i + match] == src[reference + match])
+		{
+			match++;
+		}
+
+		WriteSequence(out, src + anchor, i - anchor, i - reference, match);
+
+		i += match;
+		anchor = i;
+	}
+
+	WriteSequence(out, src + anchor, size - anchor, 0, 0);
+	return out;
+}
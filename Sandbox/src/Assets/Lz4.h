@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LZ4 block format as used by the engine's asset blobs, without the frame header.
+
+// Decompresses src into exactly dst_size bytes. Returns false for malformed blocks or a size mismatch.
+bool Lz4Decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size);
+
+// Greedy single pass compressor, meant for offline asset processing
+std::vector<uint8_t> Lz4Compress(const uint8_t* src, size_t size);
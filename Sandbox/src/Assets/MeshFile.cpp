@@ -0,0 +1,250 @@
+#include "MeshFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Lz4.h"
+
+static constexpr char MESH_FILE_MAGIC[4] = { 'M', 'O', 'D', 'L' };
+static constexpr uint32_t MESH_FILE_VERSION = 1;
+
+struct MeshFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t json_size;
+	uint32_t blob_size;
+};
+
+// The header is flat json written by the engine's asset importer, only the fields meshes need are read
+static const char* FindJsonValue(const std::string& json, const char* key)
+{
+	const std::string pattern = std::string("\"") + key + "\":";
+	size_t position = json.find(pattern);
+	return position == std::string::npos ? nullptr : json.c_str() + position + pattern.size();
+}
+
+static bool ReadJsonNumber(const std::string& json, const char* key, uint64_t& value)
+{
+	const char* text = FindJsonValue(json, key);
+	if (!text)
+	{
+		return false;
+	}
+
+	char* end = nullptr;
+	value = strtoull(text, &end, 10);
+	return end != text;
+}
+
+static bool ReadJsonString(const std::string& json, const char* key, std::string& value)
+{
+	const char* text = FindJsonValue(json, key);
+	if (!text || *text != '"')
+	{
+		return false;
+	}
+
+	const char* end = strchr(text + 1, '"');
+	if (!end)
+	{
+		return false;
+	}
+
+	value.assign(text + 1, end);
+	return true;
+}
+
+static bool ReadFile(const std::string& path, std::vector<uint8_t>& data)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file)
+	{
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+	bool read = fread(data.data(), 1, data.size(), file) == data.size();
+	fclose(file);
+
+	return read;
+}
+
+bool ReadMeshFile(const std::string& path, MeshFile& mesh)
+{
+	std::vector<uint8_t> data;
+	if (!ReadFile(path, data) || data.size() < sizeof(MeshFileHeader))
+	{
+		return false;
+	}
+
+	MeshFileHeader header;
+	memcpy(&header, data.data(), sizeof(header));
+
+	if (memcmp(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC)) != 0 || header.version != MESH_FILE_VERSION)
+	{
+		return false;
+	}
+
+	if (static_cast<uint64_t>(sizeof(header)) + header.json_size + header.blob_size > data.size())
+	{
+		return false;
+	}
+
+	const std::string json(reinterpret_cast<const char*>(data.data() + sizeof(header)), header.json_size);
+	const uint8_t* blob = data.data() + sizeof(header) + header.json_size;
+
+	uint64_t vertex_buffer_size = 0;
+	uint64_t index_buffer_size = 0;
+	if (!ReadJsonNumber(json, "vertex_buffer_size", vertex_buffer_size) || !ReadJsonNumber(json, "index_buffer_size", index_buffer_size))
+	{
+		return false;
+	}
+
+	// Only written for simplified meshes
+	uint64_t source_vertex_buffer_size = 0;
+	uint64_t source_vertex_count = 0;
+	ReadJsonNumber(json, "source_vertex_buffer_size", source_vertex_buffer_size);
+	ReadJsonNumber(json, "source_vertex_count", source_vertex_count);
+
+	if (vertex_buffer_size % sizeof(MeshFileVertex) != 0 || index_buffer_size % sizeof(uint32_t) != 0)
+	{
+		return false;
+	}
+
+	if (source_vertex_buffer_size > 0 && source_vertex_buffer_size / sizeof(uint32_t) != vertex_buffer_size / sizeof(MeshFileVertex))
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> buffers(vertex_buffer_size + index_buffer_size + source_vertex_buffer_size);
+
+	std::string compression_mode;
+	ReadJsonString(json, "compression_mode", compression_mode);
+	if (compression_mode == "LZ4")
+	{
+		if (!Lz4Decompress(blob, header.blob_size, buffers.data(), buffers.size()))
+		{
+			return false;
+		}
+	}
+	else if (header.blob_size == buffers.size())
+	{
+		memcpy(buffers.data(), blob, buffers.size());
+	}
+	else
+	{
+		return false;
+	}
+
+	mesh.vertices.resize(vertex_buffer_size / sizeof(MeshFileVertex));
+	mesh.indices.resize(index_buffer_size / sizeof(uint32_t));
+	mesh.source_vertices.resize(source_vertex_buffer_size / sizeof(uint32_t));
+	memcpy(mesh.vertices.data(), buffers.data(), vertex_buffer_size);
+	memcpy(mesh.indices.data(), buffers.data() + vertex_buffer_size, index_buffer_size);
+	memcpy(mesh.source_vertices.data(), buffers.data() + vertex_buffer_size + index_buffer_size, source_vertex_buffer_size);
+
+	for (uint32_t index : mesh.indices)
+	{
+		if (index >= mesh.vertices.size())
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t vertex : mesh.source_vertices)
+	{
+		if (vertex >= source_vertex_count)
+		{
+			return false;
+		}
+	}
+
+	mesh.source_vertex_count = static_cast<uint32_t>(source_vertex_count);
+
+	uint64_t lod = 0;
+	ReadJsonNumber(json, "lod", lod);
+	mesh.lod = static_cast<uint32_t>(lod);
+
+	mesh.original_file_path.clear();
+	ReadJsonString(json, "original_file_path", mesh.original_file_path);
+
+	return true;
+}
+
+bool WriteMeshFile(const std::string& path, const MeshFile& mesh)
+{
+	const size_t vertex_buffer_size = mesh.vertices.size() * sizeof(MeshFileVertex);
+	const size_t index_buffer_size = mesh.indices.size() * sizeof(uint32_t);
+	const size_t source_vertex_buffer_size = mesh.source_vertices.size() * sizeof(uint32_t);
+
+	std::vector<uint8_t> buffers(vertex_buffer_size + index_buffer_size + source_vertex_buffer_size);
+	if (vertex_buffer_size > 0)
+	{
+		memcpy(buffers.data(), mesh.vertices.data(), vertex_buffer_size);
+	}
+
+	if (index_buffer_size > 0)
+	{
+		memcpy(buffers.data() + vertex_buffer_size, mesh.indices.data(), index_buffer_size);
+	}
+
+	if (source_vertex_buffer_size > 0)
+	{
+		memcpy(buffers.data() + vertex_buffer_size + index_buffer_size, mesh.source_vertices.data(), source_vertex_buffer_size);
+	}
+
+	const std::vector<uint8_t> blob = Lz4Compress(buffers.data(), buffers.size());
+
+	// Keys in the importer's order, the level and source vertices are only written for simplified meshes
+	std::string json = "{\"compression_mode\":\"LZ4\",\"index_buffer_size\":" + std::to_string(index_buffer_size);
+	if (mesh.lod > 0)
+	{
+		json += ",\"lod\":" + std::to_string(mesh.lod);
+	}
+
+	json += ",\"original_file_path\":\"" + mesh.original_file_path + "\"";
+	if (source_vertex_buffer_size > 0)
+	{
+		json += ",\"source_vertex_buffer_size\":" + std::to_string(source_vertex_buffer_size) + ",\"source_vertex_count\":" + std::to_string(mesh.source_vertex_count);
+	}
+
+	json += ",\"vertex_buffer_size\":" + std::to_string(vertex_buffer_size) + "}";
+
+	MeshFileHeader header;
+	memcpy(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC));
+	header.version = MESH_FILE_VERSION;
+	header.json_size = static_cast<uint32_t>(json.size());
+	header.blob_size = static_cast<uint32_t>(blob.size());
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	written = written && fwrite(json.data(), 1, json.size(), file) == json.size();
+	written = written && fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+
+	return fclose(file) == 0 && written;
+}
+
+std::string MeshLodPath(const std::string& path, uint32_t lod)
+{
+	const std::string suffix = "_lod" + std::to_string(lod);
+
+	size_t extension = path.rfind('.');
+	size_t directory = path.find_last_of("/\\");
+	if (extension == std::string::npos || (directory != std::string::npos && extension < directory))
+	{
+		return path + suffix;
+	}
+
+	return path.substr(0, extension) + suffix + path.substr(extension);
+}
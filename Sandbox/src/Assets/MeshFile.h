@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Vertex layout of .ymesh files, skinned meshes keep their bone weights in the model and index them like these vertices
+struct MeshFileVertex
+{
+    float position[3];
+    float color[3];
+    float normal[3];
+    float uv[2];
+};
+
+static_assert(sizeof(MeshFileVertex) == 44, "MeshFileVertex must match the .ymesh vertex stride");
+
+// Contents of a .ymesh file. Files are MODL containers:
+// "MODL" | version | header size | blob size | json header | LZ4 blob of the vertex buffer followed by the index buffer,
+// simplified meshes append the source vertex index of each vertex
+struct MeshFile
+{
+    std::vector<MeshFileVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    std::string original_file_path;
+
+    // Level of detail of a simplified mesh, 0 for source meshes
+    uint32_t lod = 0;
+
+    // Vertex of the source mesh each vertex was taken from, so skinned levels find their bone weights. Empty for source meshes.
+    std::vector<uint32_t> source_vertices;
+    uint32_t source_vertex_count = 0;
+};
+
+// Returns false if the file is missing or malformed
+bool ReadMeshFile(const std::string& path, MeshFile& mesh);
+bool WriteMeshFile(const std::string& path, const MeshFile& mesh);
+
+// Path of a mesh's simplified level, i.e. assets/meshes/MutantMesh.ymesh -> assets/meshes/MutantMesh_lod1.ymesh
+std::string MeshLodPath(const std::string& path, uint32_t lod);
@@ -0,0 +1,216 @@
+#include "MeshSimplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+
+// Cells along the longest side of the mesh tried by the search for the finest grid that meets the target
+static constexpr uint32_t MIN_GRID_RESOLUTION = 1;
+static constexpr uint32_t MAX_GRID_RESOLUTION = 1024;
+
+// Major axis and sign of a normal, 0 for degenerate normals
+static uint32_t NormalBucket(const float normal[3])
+{
+	uint32_t axis = 0;
+	for (uint32_t i = 1; i < 3; i++)
+	{
+		if (std::fabs(normal[i]) > std::fabs(normal[axis]))
+		{
+			axis = i;
+		}
+	}
+
+	return axis * 2 + (normal[axis] < 0.0f ? 1 : 0);
+}
+
+struct ClusterGrid
+{
+	float min[3] = {};
+	float cell = 1.0f;
+	uint64_t dims[3] = {};
+};
+
+static ClusterGrid MakeGrid(const float min[3], const float max[3], uint32_t resolution)
+{
+	ClusterGrid grid;
+
+	float extent = 0.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		grid.min[axis] = min[axis];
+		extent = std::max(extent, max[axis] - min[axis]);
+	}
+
+	grid.cell = extent > 0.0f ? extent / resolution : 1.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		grid.dims[axis] = std::max<uint64_t>(static_cast<uint64_t>(std::ceil((max[axis] - min[axis]) / grid.cell)), 1);
+	}
+
+	return grid;
+}
+
+static uint64_t ClusterKey(const ClusterGrid& grid, const MeshFileVertex& vertex)
+{
+	uint64_t cell[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float offset = std::max((vertex.position[axis] - grid.min[axis]) / grid.cell, 0.0f);
+		cell[axis] = std::min(static_cast<uint64_t>(offset), grid.dims[axis] - 1);
+	}
+
+	return ((cell[0] * grid.dims[1] + cell[1]) * grid.dims[2] + cell[2]) * 6 + NormalBucket(vertex.normal);
+}
+
+// Remaps the triangles onto one vertex per cluster, the one closest to the cluster's centroid
+static void ClusterIndices(const std::vector<MeshFileVertex>& vertices, const std::vector<uint32_t>& indices, const ClusterGrid& grid, std::vector<uint32_t>& result)
+{
+	std::unordered_map<uint64_t, uint32_t> cluster_ids;
+	std::unordered_map<uint32_t, uint32_t> vertex_clusters;
+	std::vector<std::pair<uint32_t, uint32_t>> cluster_vertices;
+
+	for (uint32_t index : indices)
+	{
+		if (vertex_clusters.count(index))
+		{
+			continue;
+		}
+
+		auto [it, inserted] = cluster_ids.emplace(ClusterKey(grid, vertices[index]), static_cast<uint32_t>(cluster_ids.size()));
+		vertex_clusters[index] = it->second;
+		cluster_vertices.push_back({ it->second, index });
+	}
+
+	std::vector<double> centroids(cluster_ids.size() * 3, 0.0);
+	std::vector<uint32_t> counts(cluster_ids.size(), 0);
+	for (const auto& [cluster, vertex] : cluster_vertices)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			centroids[cluster * 3 + axis] += vertices[vertex].position[axis];
+		}
+
+		counts[cluster]++;
+	}
+
+	std::vector<uint32_t> representatives(cluster_ids.size(), UINT32_MAX);
+	std::vector<double> distances(cluster_ids.size(), 0.0);
+	for (const auto& [cluster, vertex] : cluster_vertices)
+	{
+		double distance = 0.0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			double d = vertices[vertex].position[axis] - centroids[cluster * 3 + axis] / counts[cluster];
+			distance += d * d;
+		}
+
+		if (representatives[cluster] == UINT32_MAX || distance < distances[cluster])
+		{
+			representatives[cluster] = vertex;
+			distances[cluster] = distance;
+		}
+	}
+
+	// Collapsed and repeated triangles are dropped, the rest keep their order and winding
+	const bool dedupe = vertices.size() < (size_t(1) << 21);
+	std::unordered_set<uint64_t> triangles;
+
+	result.clear();
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t a = representatives[vertex_clusters[indices[i]]];
+		uint32_t b = representatives[vertex_clusters[indices[i + 1]]];
+		uint32_t c = representatives[vertex_clusters[indices[i + 2]]];
+
+		if (a == b || b == c || a == c)
+		{
+			continue;
+		}
+
+		if (dedupe)
+		{
+			// Rotated so the smallest index leads, which keeps the winding
+			uint32_t first = std::min({ a, b, c });
+			uint32_t rotated[3] = { a, b, c };
+			std::rotate(rotated, std::find(rotated, rotated + 3, first), rotated + 3);
+
+			uint64_t key = (static_cast<uint64_t>(rotated[0]) << 42) | (static_cast<uint64_t>(rotated[1]) << 21) | rotated[2];
+			if (!triangles.insert(key).second)
+			{
+				continue;
+			}
+		}
+
+		result.push_back(a);
+		result.push_back(b);
+		result.push_back(c);
+	}
+}
+
+std::vector<uint32_t> SimplifyIndices(const std::vector<MeshFileVertex>& vertices, const std::vector<uint32_t>& indices, float target_ratio)
+{
+	const size_t triangle_count = indices.size() / 3;
+	const size_t target = static_cast<size_t>(triangle_count * std::clamp(target_ratio, 0.0f, 1.0f));
+	if (target >= triangle_count || indices.empty())
+	{
+		return indices;
+	}
+
+	float min[3] = { INFINITY, INFINITY, INFINITY };
+	float max[3] = { -INFINITY, -INFINITY, -INFINITY };
+	for (uint32_t index : indices)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			min[axis] = std::min(min[axis], vertices[index].position[axis]);
+			max[axis] = std::max(max[axis], vertices[index].position[axis]);
+		}
+	}
+
+	// Finer grids keep more triangles, search for the finest one within the target
+	std::vector<uint32_t> best;
+	std::vector<uint32_t> candidate;
+	ClusterIndices(vertices, indices, MakeGrid(min, max, MIN_GRID_RESOLUTION), best);
+
+	uint32_t low = MIN_GRID_RESOLUTION + 1;
+	uint32_t high = MAX_GRID_RESOLUTION;
+	while (low <= high)
+	{
+		uint32_t resolution = low + (high - low) / 2;
+		ClusterIndices(vertices, indices, MakeGrid(min, max, resolution), candidate);
+
+		if (candidate.size() / 3 <= target)
+		{
+			best.swap(candidate);
+			low = resolution + 1;
+		}
+		else
+		{
+			high = resolution - 1;
+		}
+	}
+
+	return best;
+}
+
+std::vector<uint32_t> CompactVertices(const std::vector<MeshFileVertex>& vertices, std::vector<uint32_t>& indices, std::vector<MeshFileVertex>& compacted)
+{
+	std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+	std::vector<uint32_t> source_vertices;
+
+	compacted.clear();
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == UINT32_MAX)
+		{
+			remap[index] = static_cast<uint32_t>(compacted.size());
+			compacted.push_back(vertices[index]);
+			source_vertices.push_back(index);
+		}
+
+		index = remap[index];
+	}
+
+	return source_vertices;
+}
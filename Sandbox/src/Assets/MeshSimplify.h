@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MeshFile.h"
+
+// Simplifies a triangle list to at most target_ratio of its triangles by clustering vertices on a grid.
+// Triangles are remapped onto one existing vertex per cluster, so the result still indexes the source vertices.
+// Vertices facing different axes are never merged, which keeps both sides of thin parts apart.
+std::vector<uint32_t> SimplifyIndices(const std::vector<MeshFileVertex>& vertices, const std::vector<uint32_t>& indices, float target_ratio);
+
+// Keeps only the vertices the indices use, in order of first use, and remaps the indices onto them.
+// Returns the source vertex of each kept vertex.
+std::vector<uint32_t> CompactVertices(const std::vector<MeshFileVertex>& vertices, std::vector<uint32_t>& indices, std::vector<MeshFileVertex>& compacted);
@@ -11,6 +11,8 @@ class SceneGraph;
 class ScriptingSystem;
 class ParticleSystemManager;
 class RenderSceneSystem;
+class RenderPipeline;
+class TaskGraph;
 
 namespace yoyo
 {
@@ -49,6 +51,12 @@ private:
     Ref<ParticleSystemManager> m_particles;
     Ref<RenderSceneSystem> m_render_scene;
 
+    // Schedules the systems above each frame
+    Ref<TaskGraph> m_task_graph;
+
+    // Hands the frames filled by the render scene and particles to the renderer
+    Ref<RenderPipeline> m_render_pipeline;
+
     Scene* m_scene;
     yoyo::Application* m_app;
 };
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include <entt/entt.hpp>
+
+// Entities whose component changed since the owner last cleared the set, filled by Scene::MarkChanged once tracked with Scene::Track.
+// Entries may since have been destroyed or lost the component, consumers check before use.
+class ChangeSet
+{
+public:
+    ChangeSet() = default;
+    ~ChangeSet() = default;
+
+    ChangeSet(const ChangeSet&) = delete;
+    ChangeSet& operator=(const ChangeSet&) = delete;
+
+    // In the order they were first marked
+    const std::vector<entt::entity>& Entities() const { return m_entities; }
+
+    bool Empty() const { return m_entities.empty(); }
+
+    void Clear()
+    {
+        for (entt::entity id : m_entities)
+        {
+            m_marks[static_cast<uint32_t>(entt::to_entity(id))] = entt::null;
+        }
+
+        m_entities.clear();
+    }
+private:
+    friend class Scene;
+
+    void Add(entt::entity id)
+    {
+        uint32_t index = static_cast<uint32_t>(entt::to_entity(id));
+        if (index >= m_marks.size())
+        {
+            m_marks.resize(index + 1, entt::null);
+        }
+
+        // Already in the set
+        if (m_marks[index] == id)
+        {
+            return;
+        }
+
+        m_marks[index] = id;
+        m_entities.push_back(id);
+    }
+private:
+    std::vector<entt::entity> m_entities;
+
+    // Indexed by entity index, the id added to the set
+    std::vector<entt::entity> m_marks;
+};
@@ -5,6 +5,7 @@
 
 #include "Core/Assert.h"
 #include "ECS/EntityImpl.h"
+#include "SceneGraph/SceneGraph.h"
 
 const yoyo::Vec3& TransformComponent::Forward() const
 {
@@ -13,69 +14,137 @@ const yoyo::Vec3& TransformComponent::Forward() const
 
 void TransformComponent::AddChild(Entity e)
 {
-    YASSERT(children_count < MAX_CHILDREN, "Max child count reached!");
+    TransformComponent& child = e.GetComponent<TransformComponent>();
 
     // Remove from previous parent if exists
-    Entity previous_parent = e.GetComponent<TransformComponent>().parent;
+    Entity previous_parent = child.parent;
     if(previous_parent.IsValid())
     {
         previous_parent.GetComponent<TransformComponent>().RemoveChild(e);
     }
 
     // Parent child self and update 
-    e.GetComponent<TransformComponent>().parent = self;
+    child.parent = self;
 
-    // Add to child list
-    children[children_count++] = e;
+    // Append to child list
+    child.prev_sibling = last_child;
+    child.next_sibling = {};
+    if (last_child)
+    {
+        last_child.GetComponent<TransformComponent>().next_sibling = e;
+    }
+    else
+    {
+        first_child = e;
+    }
+    last_child = e;
+    children_count++;
+
+    if (m_scene_graph)
+    {
+        m_scene_graph->OnParentChanged(child);
+    }
 
     // Update self before updating new child
     UpdateModelMatrix();
-    e.GetComponent<TransformComponent>().UpdateModelMatrix();
+    child.UpdateModelMatrix();
+
+    // Descendants of the child are now relative to a new parent
+    child.MarkDirty();
 }
 
 void TransformComponent::RemoveChild(Entity e)
 {
-    int insert_index = -1;
-    for (uint32_t i = 0; i < children_count; i++)
+    TransformComponent& child = e.GetComponent<TransformComponent>();
+    if (child.parent != self)
     {
-        if (children[i] == e)
-        {
-            insert_index = i;
-            break;
-        }
+        YASSERT(false, "Child is not parented by object!");
+        return;
     }
 
-    if (insert_index < 0)
+    // Unlink from siblings
+    if (child.prev_sibling)
     {
-        YASSERT("Child is not parented by object!");
-        return;
+        child.prev_sibling.GetComponent<TransformComponent>().next_sibling = child.next_sibling;
+    }
+    else
+    {
+        first_child = child.next_sibling;
     }
 
-    int back_index = children_count - 1;
-    if (back_index > -1)
+    if (child.next_sibling)
     {
-        Entity back = children[back_index];
-        if (back != e)
-        {
-            children[insert_index] = back;
-        }
+        child.next_sibling.GetComponent<TransformComponent>().prev_sibling = child.prev_sibling;
+    }
+    else
+    {
+        last_child = child.prev_sibling;
     }
     children_count--;
 
-    e.GetComponent<TransformComponent>().parent = {}; 
+    child.parent = {};
+    child.next_sibling = {};
+    child.prev_sibling = {};
+
+    if (m_scene_graph)
+    {
+        m_scene_graph->OnParentChanged(child);
+    }
 }
 
-void TransformComponent::UpdateModelMatrix()
+void TransformComponent::SetPosition(const yoyo::Vec3& new_position)
 {
-    if (parent)
+    position = new_position;
+    MarkDirty();
+}
+
+void TransformComponent::SetRotation(const yoyo::Quat& new_rotation)
+{
+    quat_rotation = new_rotation;
+    MarkDirty();
+}
+
+void TransformComponent::SetScale(const yoyo::Vec3& new_scale)
+{
+    scale = new_scale;
+    MarkDirty();
+}
+
+void TransformComponent::MarkDirty()
+{
+    m_dirty = true;
+
+    if (m_scene_graph && !m_queued)
     {
-        model_matrix = parent.GetComponent<TransformComponent>().model_matrix * LocalModelMatrix();
+        m_queued = true;
+        m_scene_graph->QueueDirty(self);
     }
-    else
+
+    // Flag ancestors until one already leads to a dirty node
+    Entity node = parent;
+    while (node)
+    {
+        TransformComponent& node_transform = node.GetComponent<TransformComponent>();
+        if (node_transform.m_child_dirty)
+        {
+            break;
+        }
+
+        node_transform.m_child_dirty = true;
+        node = node_transform.parent;
+    }
+}
+
+void TransformComponent::UpdateModelMatrix()
+{
+    if (parent)
     {
-        model_matrix = LocalModelMatrix();
+        UpdateModelMatrix(parent.GetComponent<TransformComponent>().model_matrix);
+        return;
     }
 
+    model_matrix = LocalModelMatrix();
+
     // TODO: Clamp
     // Update euler angles
     rotation = yoyo::EulerAnglesFromQuat(yoyo::NormalizeQuat(quat_rotation));
@@ -87,7 +156,12 @@ void TransformComponent::UpdateModelMatrix()
     // {
     //     rotation.y = 180 - rotation.y;
     // }
-    m_dirty = false;
+}
+
+void TransformComponent::UpdateModelMatrix(const yoyo::Mat4x4& parent_model_matrix)
+{
+    model_matrix = parent_model_matrix * LocalModelMatrix();
+    rotation = yoyo::EulerAnglesFromQuat(yoyo::NormalizeQuat(quat_rotation));
 }
 
 yoyo::Mat4x4 TransformComponent::LocalModelMatrix() {
@@ -108,6 +182,7 @@ void TransformComponent::SetGlobalTransform(const yoyo::Mat4x4 transform_matrix)
         scale = yoyo::ScaleFromMat4x4(transform_matrix);
         quat_rotation = yoyo::RotationFromMat4x4(transform_matrix);
         position = yoyo::PositionFromMat4x4(transform_matrix);
+        MarkDirty();
 
         YASSERT(0);
         return;
@@ -119,6 +194,7 @@ void TransformComponent::SetGlobalTransform(const yoyo::Mat4x4 transform_matrix)
 	quat_rotation = yoyo::RotationFromMat4x4(local_matrix);
 	position = yoyo::PositionFromMat4x4(local_matrix);
 
+    MarkDirty();
     UpdateModelMatrix();
 }
 
@@ -128,5 +204,6 @@ void TransformComponent::SetLocalTransform(const yoyo::Mat4x4 transform)
 	quat_rotation = yoyo::RotationFromMat4x4(transform);
 	position = yoyo::PositionFromMat4x4(transform);
 
+    MarkDirty();
     UpdateModelMatrix();
 }
@@ -4,11 +4,17 @@
 #include <Math/Quaternion.h>
 
 #include "ECS/Entity.h"
+#include "ECS/Tag.h"
 
-static const int MAX_CHILDREN = 200;
+class SceneGraph;
+
+static const uint32_t INVALID_GRAPH_SLOT = UINT32_MAX;
 struct TransformComponent
 {
 public:
+    // The scene graph holds pointers to transforms, keep them stable on deletion
+    static constexpr auto in_place_delete = true;
+
     yoyo::Vec3 position{ 0.0f , 0.0f, 0.0f};
     yoyo::Vec3 rotation{ 0.0f , 0.0f, 0.0f}; // Rotation in euler radians
     yoyo::Vec3 scale{ 1.0f , 1.0f, 1.0f};
@@ -19,7 +25,12 @@ public:
 
     Entity self = {};
     Entity parent = {};
-    std::array<Entity, MAX_CHILDREN> children = {};
+
+    // Intrusive child list in the order children were added, iterate with first_child -> next_sibling
+    Entity first_child = {};
+    Entity last_child = {};
+    Entity next_sibling = {};
+    Entity prev_sibling = {};
     uint32_t children_count = 0;
 
     yoyo::Quat quat_rotation = {0.0f, 0.0f, 0.0f, 1.0f};
@@ -27,8 +38,20 @@ public:
     // Parenting
     void AddChild(Entity e);
     void RemoveChild(Entity e);
+public:
+    // Setters mark the transform dirty, direct writes to the fields must call MarkDirty
+    void SetPosition(const yoyo::Vec3& new_position);
+    void SetRotation(const yoyo::Quat& new_rotation);
+    void SetScale(const yoyo::Vec3& new_scale);
+
+    // Flags the transform and its subtree for recomputation by the scene graph
+    void MarkDirty();
+
+    bool IsDirty() const { return m_dirty; }
+    bool IsChildDirty() const { return m_child_dirty; }
 public:
     void UpdateModelMatrix();
+    void UpdateModelMatrix(const yoyo::Mat4x4& parent_model_matrix);
     yoyo::Mat4x4 LocalModelMatrix();
 
     void SetGlobalTransform(const yoyo::Mat4x4 transform);
@@ -44,7 +67,16 @@ public:
 
     void SetLocalTranslationMatrix(const yoyo::Mat4x4& mat) {m_local_translation_matrix = mat;}
 private:
-    bool m_dirty = false;
+    friend class SceneGraph;
+
+    bool m_dirty = true;
+    bool m_child_dirty = false; // A node in the subtree is dirty
+    bool m_queued = false; // Waiting in the scene graph's dirty lists
+
+    // Location in the scene graph levels
+    SceneGraph* m_scene_graph = nullptr;
+    uint32_t m_graph_depth = 0;
+    uint32_t m_graph_slot = INVALID_GRAPH_SLOT;
 
     yoyo::Mat4x4 m_local_translation_matrix{};
     yoyo::Mat4x4 m_local_rotation_matrix{};
@@ -55,5 +87,21 @@ private:
 
 struct TagComponent
 {
-    std::string tag;
+    TagComponent(Tag tag = {})
+        :tag(tag) {}
+
+    // Indexed by the scene, rename through Scene::SetTag
+    Tag tag;
+private:
+    friend class Scene;
+
+    // Position in the scene's tag index
+    uint32_t m_index_slot = UINT32_MAX;
+};
+
+// Disabled entities are skipped by systems, see Scene::Disable
+struct DisabledComponent
+{
+    // Disabled by Scene::SetEnabled on the entity itself rather than through an ancestor, it stays disabled when the ancestor is enabled
+    bool self = false;
 };
\ No newline at end of file
@@ -6,10 +6,8 @@
 
 MeshRendererComponent::MeshRendererComponent()
 {
-}
-
-MeshRendererComponent::~MeshRendererComponent()
-{
+	// Submitted to the render packet by MeshSubsystem
+	mesh_object = RenderObject<yoyo::MeshPassObject>::Create();
 }
 
 const Ref<yoyo::Material>& MeshRendererComponent::GetMaterial() const
@@ -21,19 +19,30 @@ void MeshRendererComponent::SetMaterial(Ref<yoyo::Material> new_material)
 {
 	// Append mesh pass object
 	mesh_object->material = new_material;
+
+	for (RenderObject<yoyo::MeshPassObject>& lod_object : lod_objects)
+	{
+		lod_object->material = new_material;
+	}
 }
 
 const Ref<yoyo::IMesh>& MeshRendererComponent::GetMesh() const
 {
-	return mesh_object->mesh;
+	return lods ? lods->meshes.front() : mesh_object->mesh;
 }
 
 void MeshRendererComponent::SetMesh(Ref<yoyo::IMesh> mesh) 
 {
 	mesh_object->mesh = mesh;
+
+	// Levels of another mesh no longer apply
+	if (lods && lods->meshes.front() != mesh)
+	{
+		lods = nullptr;
+	}
 }
 
 AnimatorComponent::AnimatorComponent() 
 {
-	animator = CreateRef<yoyo::Animator>();
+	animator = RenderObject<yoyo::Animator>::Create();
 }
@@ -7,6 +7,9 @@
 #include <Renderer/Model.h>
 #include <Renderer/RenderScene.h>
 
+#include "RenderScene/RenderObjectPool.h"
+#include "RenderScene/MeshLod.h"
+
 // Forward declarations
 namespace yoyo
 {
@@ -24,36 +27,46 @@ struct DirectionalLightComponent
 
 struct CameraComponent
 {
-    Ref<yoyo::Camera> camera;
+    // Created by CameraSubsystem
+    RenderObject<yoyo::Camera> camera;
     bool active;
 };
 
 struct MeshRendererComponent
 {
     MeshRendererComponent();
-    ~MeshRendererComponent();
 
     yoyo::MeshType type = yoyo::MeshType::Static;
 
     const Ref<yoyo::Material>& GetMaterial() const;
     void SetMaterial(Ref<yoyo::Material> material);
 
+    // The full detail mesh, drawn by mesh_object. Once MeshSubsystem created the render proxy, set it through Scene::Patch
+    // so the proxy's bounds and lod_objects follow the new mesh.
     const Ref<yoyo::IMesh>& GetMesh() const;
     void SetMesh(Ref<yoyo::IMesh> mesh);
 
-    Ref<yoyo::MeshPassObject> mesh_object;
+    RenderObject<yoyo::MeshPassObject> mesh_object;
+
+    // Mesh objects drawing the coarser levels of detail, created with the render proxy by MeshSubsystem
+    std::vector<RenderObject<yoyo::MeshPassObject>> lod_objects;
+
+    // Levels of detail of the mesh, null to always draw it at full detail. Set before the component is created, i.e. in a prefab.
+    Ref<MeshLodChain> lods;
+
+    // Slot in the render scene's proxy buffer, assigned by MeshSubsystem
+    uint32_t proxy = UINT32_MAX;
 };
 
 namespace yoyo{class Animator;}
 struct AnimatorComponent
 {
     AnimatorComponent();
-    ~AnimatorComponent() = default;
 
-    Ref<yoyo::Animator> animator;
+    RenderObject<yoyo::Animator> animator;
 };
 
 struct DebugColliderRendererComponent
 {
-    Ref<yoyo::MeshPassObject> mesh_object;
+    RenderObject<yoyo::MeshPassObject> mesh_object;
 };
\ No newline at end of file
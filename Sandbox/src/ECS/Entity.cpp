@@ -17,7 +17,7 @@ const bool Entity::IsValid() const
 std::ostream& operator<<(std::ostream& stream, Entity& e)
 {
 	TagComponent& tag = e.m_scene->GetComponent<TagComponent>(e.m_id);
-	stream << e.Id() << ":" << tag.tag;
+	stream << e.Id() << ":" << tag.tag.Str();
 
 	return stream;
 }
\ No newline at end of file
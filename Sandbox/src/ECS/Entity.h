@@ -31,6 +31,10 @@ public:
     template <typename T>
     bool TryGetComponent(T** out);
 
+    // Returns component of type <T> or null
+    template <typename T>
+    T* TryGetComponent();
+
     const bool IsValid() const;
 
     // Returns entity handle
@@ -34,12 +34,13 @@ T& Entity::GetComponent()
 template <typename T>
 bool Entity::TryGetComponent(T** out)
 {
-	if(!HasComponent<T>())
-	{
-		out = nullptr;
-		return false;
-	}
+	*out = TryGetComponent<T>();
+	return *out != nullptr;
+}
 
-	*out = &GetComponent<T>();
-	return true;
+template <typename T>
+T* Entity::TryGetComponent()
+{
+	YASSERT(m_scene != nullptr, "Entity does not belong to a scene!");
+	return m_scene->TryGetComponent<T>(m_id);
 }
\ No newline at end of file
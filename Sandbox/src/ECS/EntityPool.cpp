@@ -0,0 +1,112 @@
+#include "EntityPool.h"
+
+#include "Scene.h"
+#include "Prefab.h"
+#include "Components/Components.h"
+
+EntityPool::EntityPool(Scene* scene, const Prefab& prefab)
+	:m_scene(scene), m_prefab(prefab)
+{
+	YASSERT(m_scene, "Entity pool created with null scene!");
+}
+
+void EntityPool::Reserve(uint32_t count)
+{
+	while (m_instances.size() < count)
+	{
+		Release(Create({}));
+	}
+}
+
+Entity EntityPool::Acquire(const yoyo::Vec3& position)
+{
+	if (m_parked.empty())
+	{
+		return Create(position);
+	}
+
+	Entity root = m_parked.back();
+	m_parked.pop_back();
+	root.GetComponent<PooledComponent>().parked = false;
+
+	m_prefab.ResetRoot(root, position);
+	m_scene->Root().GetComponent<TransformComponent>().AddChild(root);
+
+	CollectNodes(root, nullptr);
+	m_scene->Enable(m_nodes);
+	m_scene->m_acquire_batch_signal.publish(m_nodes);
+
+	return root;
+}
+
+void EntityPool::Release(Entity root)
+{
+	PooledComponent& pooled = root.GetComponent<PooledComponent>();
+	YASSERT(pooled.pool == this && pooled.root == root, "Entity released to a pool it does not belong to!");
+	if (pooled.parked)
+	{
+		return;
+	}
+	pooled.parked = true;
+
+	std::vector<Entity> foreign;
+	CollectNodes(root, &foreign);
+
+	// Joins the running destruction batch when released by the scene
+	for (Entity child : foreign)
+	{
+		m_scene->Destroy(child);
+	}
+
+	m_scene->Disable(m_nodes);
+
+	// Orphans are not part of the scene graph levels
+	TransformComponent& transform = root.GetComponent<TransformComponent>();
+	if (transform.parent)
+	{
+		transform.parent.GetComponent<TransformComponent>().RemoveChild(root);
+	}
+
+	m_parked.push_back(root);
+}
+
+Entity EntityPool::Create(const yoyo::Vec3& position)
+{
+	Entity root = m_prefab.Instantiate(m_scene, position);
+
+	CollectNodes(root, nullptr);
+	for (entt::entity id : m_nodes)
+	{
+		m_scene->Registry().emplace<PooledComponent>(id, PooledComponent{ this, root });
+	}
+
+	m_instances.push_back(root);
+	return root;
+}
+
+void EntityPool::CollectNodes(Entity root, std::vector<Entity>* foreign)
+{
+	m_nodes.clear();
+	m_stack.clear();
+	m_stack.push_back(root);
+
+	while (!m_stack.empty())
+	{
+		Entity node = m_stack.back();
+		m_stack.pop_back();
+		m_nodes.push_back(node);
+
+		for (Entity child = node.GetComponent<TransformComponent>().first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
+		{
+			const PooledComponent* pooled = m_scene->Registry().try_get<PooledComponent>(child);
+			if (!foreign || (pooled && pooled->root == root))
+			{
+				m_stack.push_back(child);
+			}
+			else
+			{
+				foreign->push_back(child);
+			}
+		}
+	}
+}
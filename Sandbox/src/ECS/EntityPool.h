@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include <Math/Math.h>
+
+#include "Entity.h"
+
+class Scene;
+class Prefab;
+class EntityPool;
+
+// Added to every node of a pooled instance, destroying any node returns the whole instance to its pool
+struct PooledComponent
+{
+    EntityPool* pool = nullptr;
+    Entity root = {};
+    bool parked = false; // Set on the root
+};
+
+// Parks disabled prefab instances instead of destroying them and reactivates them on Acquire.
+// Parked instances are detached from the hierarchy, their actors are out of the physics scene and their renderables are withdrawn.
+// Pools are owned by their scene, see Scene::Pool.
+class EntityPool
+{
+public:
+    EntityPool(Scene* scene, const Prefab& prefab);
+    ~EntityPool() = default;
+
+    // Instantiates parked instances up to count
+    void Reserve(uint32_t count);
+
+    // Returns a parked instance reset to the prefab's transform at position, or a new instance when none are parked
+    Entity Acquire(const yoyo::Vec3& position = {});
+
+    // Parks the instance, children attached after it was acquired are destroyed.
+    // Destroying a pooled entity through the scene releases it at the next flush.
+    void Release(Entity root);
+
+    uint32_t ParkedCount() const { return static_cast<uint32_t>(m_parked.size()); }
+    uint32_t InstanceCount() const { return static_cast<uint32_t>(m_instances.size()); }
+private:
+    Entity Create(const yoyo::Vec3& position);
+
+    // Collects the instance's nodes into m_nodes, other children are passed to foreign
+    void CollectNodes(Entity root, std::vector<Entity>* foreign);
+private:
+    Scene* m_scene;
+    const Prefab& m_prefab;
+
+    std::vector<Entity> m_instances;
+    std::vector<Entity> m_parked;
+
+    std::vector<entt::entity> m_nodes;
+    std::vector<Entity> m_stack;
+};
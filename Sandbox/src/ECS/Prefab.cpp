@@ -0,0 +1,140 @@
+#include "Prefab.h"
+
+#include <Math/MatrixTransform.h>
+
+#include "Scene.h"
+#include "Components/Components.h"
+
+PrefabNode Prefab::AddNode(Tag name, const yoyo::Vec3& position, PrefabNode parent)
+{
+	return AddNode(name, yoyo::TranslationMat4x4(position), parent);
+}
+
+PrefabNode Prefab::AddNode(Tag name, const yoyo::Mat4x4& transform_matrix, PrefabNode parent)
+{
+	YASSERT(m_nodes.empty() || parent.index < m_nodes.size(), "Prefab nodes other than the root must have a parent!");
+
+	Node node = {};
+	node.name = name;
+	node.parent = m_nodes.empty() ? UINT32_MAX : parent.index;
+	node.position = yoyo::PositionFromMat4x4(transform_matrix);
+	node.rotation = yoyo::RotationFromMat4x4(transform_matrix);
+	node.scale = yoyo::ScaleFromMat4x4(transform_matrix);
+
+	m_nodes.push_back(node);
+	return { static_cast<uint32_t>(m_nodes.size() - 1) };
+}
+
+Entity Prefab::Instantiate(Scene* scene, const yoyo::Vec3& position) const
+{
+	std::vector<Entity> roots;
+	Instantiate(scene, { position }, &roots);
+
+	return roots.empty() ? Entity{} : roots.front();
+}
+
+void Prefab::Instantiate(Scene* scene, const std::vector<yoyo::Vec3>& positions, std::vector<Entity>* roots) const
+{
+	YASSERT(scene, "Cannot instantiate prefab in null scene!");
+
+	const size_t node_count = m_nodes.size();
+	const size_t instance_count = positions.size();
+	if (node_count == 0 || instance_count == 0)
+	{
+		return;
+	}
+
+	entt::registry& registry = scene->Registry();
+
+	// Entities of instance i are at [i * node_count, (i + 1) * node_count) in node order
+	std::vector<entt::entity> ids(node_count * instance_count);
+	registry.create(ids.begin(), ids.end());
+
+	std::vector<Entity> entities;
+	entities.reserve(ids.size());
+	for (entt::entity id : ids)
+	{
+		entities.emplace_back(id, scene);
+	}
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		registry.emplace<TagComponent>(entities[i], m_nodes[i % node_count].name);
+	}
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		const Node& node = m_nodes[i % node_count];
+
+		TransformComponent& transform = registry.emplace<TransformComponent>(entities[i]);
+		transform.position = i % node_count == 0 ? positions[i / node_count] : node.position;
+		transform.quat_rotation = node.rotation;
+		transform.scale = node.scale;
+	}
+
+	// Link each instance while it is detached so the scene graph only sees whole subtrees
+	Entity root = scene->Root();
+	for (size_t i = 0; i < instance_count; i++)
+	{
+		Entity* instance = &entities[i * node_count];
+
+		for (size_t n = 1; n < node_count; n++)
+		{
+			instance[m_nodes[n].parent].GetComponent<TransformComponent>().AddChild(instance[n]);
+		}
+
+		root.GetComponent<TransformComponent>().AddChild(instance[0]);
+	}
+
+	for (const ComponentBatch& batch : m_batches)
+	{
+		for (size_t i = 0; i < instance_count; i++)
+		{
+			for (const auto& [node_index, construct] : batch.constructs)
+			{
+				construct(registry, &entities[i * node_count], node_index);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < instance_count; i++)
+	{
+		for (const auto& [node_index, configure] : m_configures)
+		{
+			configure(registry, &entities[i * node_count], node_index);
+		}
+	}
+
+	if (roots)
+	{
+		for (size_t i = 0; i < instance_count; i++)
+		{
+			roots->push_back(entities[i * node_count]);
+		}
+	}
+}
+
+void Prefab::ResetRoot(Entity root, const yoyo::Vec3& position) const
+{
+	YASSERT(!m_nodes.empty(), "Cannot reset instance of empty prefab!");
+
+	TransformComponent& transform = root.GetComponent<TransformComponent>();
+	transform.position = position;
+	transform.quat_rotation = m_nodes[0].rotation;
+	transform.scale = m_nodes[0].scale;
+	transform.MarkDirty();
+}
+
+Prefab::ComponentBatch& Prefab::Batch(std::type_index type)
+{
+	for (ComponentBatch& batch : m_batches)
+	{
+		if (batch.type == type)
+		{
+			return batch;
+		}
+	}
+
+	m_batches.push_back({ type, {} });
+	return m_batches.back();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <vector>
+
+#include <Math/Math.h>
+#include <Math/Quaternion.h>
+
+#include <Core/Assert.h>
+
+#include "Entity.h"
+#include "Tag.h"
+
+class Scene;
+
+// Node of a prefab, resolved to the instance's entity when passed as a component argument
+struct PrefabNode
+{
+    uint32_t index = UINT32_MAX;
+};
+
+// Entity hierarchy and components described once and instantiated many times.
+// Entities of a wave are created in one call and each component type is constructed for every instance back to back.
+class Prefab
+{
+public:
+    Prefab() = default;
+    ~Prefab() = default;
+
+    // Adds a node, the first node added is the root of every instance and is parented to the scene root
+    PrefabNode AddNode(Tag name, const yoyo::Vec3& position = {}, PrefabNode parent = {});
+    PrefabNode AddNode(Tag name, const yoyo::Mat4x4& transform_matrix, PrefabNode parent = {});
+
+    // Constructs T on the node's entity of each instance, arguments of type PrefabNode are resolved to the instance's entity
+    template<typename T, typename... Args>
+    void AddComponent(PrefabNode node, Args&&... args)
+    {
+        YASSERT(node.index < m_nodes.size(), "Invalid prefab node!");
+
+        Construct construct = [args = std::make_tuple(std::forward<Args>(args)...)](entt::registry& registry, const Entity* instance, uint32_t node_index)
+        {
+            std::apply([&](const auto&... arg) { registry.emplace<T>(instance[node_index], Resolve(arg, instance)...); }, args);
+        };
+
+        ComponentBatch& batch = Batch(typeid(T));
+        batch.constructs.push_back({ node.index, std::move(construct) });
+    }
+
+    // Calls fn with the node's component T of each instance after all components have been constructed
+    template<typename T, typename Fn>
+    void Configure(PrefabNode node, Fn fn)
+    {
+        YASSERT(node.index < m_nodes.size(), "Invalid prefab node!");
+
+        m_configures.push_back({ node.index, [fn](entt::registry& registry, const Entity* instance, uint32_t node_index) mutable
+        {
+            fn(registry.get<T>(instance[node_index]));
+        }});
+    }
+
+    // Instantiates one instance with its root at position
+    Entity Instantiate(Scene* scene, const yoyo::Vec3& position = {}) const;
+
+    // Instantiates one instance per position, roots are appended in the same order
+    void Instantiate(Scene* scene, const std::vector<yoyo::Vec3>& positions, std::vector<Entity>* roots = nullptr) const;
+
+    // Restores the root transform of an existing instance, used when reusing pooled instances
+    void ResetRoot(Entity root, const yoyo::Vec3& position) const;
+
+    uint32_t NodeCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+private:
+    using Construct = std::function<void(entt::registry& registry, const Entity* instance, uint32_t node_index)>;
+
+    struct Node
+    {
+        Tag name;
+        uint32_t parent;
+
+        yoyo::Vec3 position;
+        yoyo::Quat rotation;
+        yoyo::Vec3 scale;
+    };
+
+    // Constructors of one component type, run for every instance before the next type
+    struct ComponentBatch
+    {
+        std::type_index type;
+        std::vector<std::pair<uint32_t, Construct>> constructs;
+    };
+
+    ComponentBatch& Batch(std::type_index type);
+
+    static Entity Resolve(const PrefabNode& node, const Entity* instance) { return instance[node.index]; }
+
+    template<typename T>
+    static const T& Resolve(const T& arg, const Entity* instance) { return arg; }
+private:
+    std::vector<Node> m_nodes;
+
+    // In order of the first component of each type added
+    std::vector<ComponentBatch> m_batches;
+    std::vector<std::pair<uint32_t, Construct>> m_configures;
+};
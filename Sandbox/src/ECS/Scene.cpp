@@ -1,15 +1,83 @@
 #include "Scene.h"
 
+#include <atomic>
+
 #include "Core/Assert.h"
+#include "Core/Log.h"
 #include "Components/Components.h"
+#include "EntityPool.h"
 #include "Math/MatrixTransform.h"
 
-Scene::Scene()
+static std::atomic<uint64_t> s_next_scene_id = 1;
+
+// Local transform only, links and scene graph slots stay with the live hierarchy
+struct TransformRecord
 {
-	m_root = Entity{ m_registry.create(), this};
+	entt::entity id;
+
+	yoyo::Vec3 position;
+	yoyo::Vec3 rotation;
+	yoyo::Vec3 scale;
+	yoyo::Quat quat_rotation;
+};
+
+static void CaptureTransforms(entt::registry& registry, SceneState& state)
+{
+	std::vector<TransformRecord>& records = state.Records<TransformRecord>();
+	registry.view<TransformComponent>().each([&](entt::entity id, const TransformComponent& transform) {
+		records.push_back({ id, transform.position, transform.rotation, transform.scale, transform.quat_rotation });
+	});
+}
+
+static void RestoreTransforms(entt::registry& registry, const SceneState& state)
+{
+	const std::vector<TransformRecord>* records = state.Find<TransformRecord>();
+	if (!records)
+	{
+		return;
+	}
+
+	for (const TransformRecord& record : *records)
+	{
+		TransformComponent& transform = registry.get<TransformComponent>(record.id);
+		transform.position = record.position;
+		transform.rotation = record.rotation;
+		transform.scale = record.scale;
+		transform.quat_rotation = record.quat_rotation;
+		transform.MarkDirty();
+	}
+}
+
+// Every entity has a transform, so the transform records hold the captured entity set and versions
+static bool SameEntities(entt::registry& registry, const SceneState& state)
+{
+	const std::vector<TransformRecord>* records = state.Find<TransformRecord>();
+	if (!records || records->size() != registry.view<TransformComponent>().size())
+	{
+		return false;
+	}
+
+	for (const TransformRecord& record : *records)
+	{
+		if (!registry.valid(record.id) || !registry.all_of<TransformComponent>(record.id))
+		{
+			return false;
+		}
+	}
 
-	auto& tag = m_root.AddComponent<TagComponent>();
-	tag.tag = "root";
+	return true;
+}
+
+Scene::Scene(SceneStorage storage)
+	:m_id(s_next_scene_id++), m_storage(storage)
+{
+	m_registry.on_construct<TagComponent>().connect<&Scene::OnTagCreated>(this);
+	m_registry.on_destroy<TagComponent>().connect<&Scene::OnTagDestroyed>(this);
+
+	m_snapshot_handlers.push_back({ &CaptureTransforms, &RestoreTransforms });
+
+	m_root = Entity{ m_registry.create(), this};
+	m_root.AddComponent<TagComponent>(Tag("root"));
 
 	TransformComponent& transform = m_root.AddComponent<TransformComponent>();
 	transform.position = {0.0f, 0.0f, 0.0f};
@@ -27,12 +95,12 @@ Entity Scene::Root()
 	return m_root;
 }
 
-Entity Scene::Instantiate(const std::string& name, const yoyo::Vec3& position, bool* serialize)
+Entity Scene::Instantiate(Tag name, const yoyo::Vec3& position)
 {
 	Entity e = {};
 	e = Entity{ m_registry.create(), this };
 
-	e.AddComponent<TagComponent>().tag = name;
+	e.AddComponent<TagComponent>(name);
 	e.AddComponent<TransformComponent>().position = position;
 
 	// Add to root of scene
@@ -41,12 +109,12 @@ Entity Scene::Instantiate(const std::string& name, const yoyo::Vec3& position, b
 	return e;
 }
 
-Entity Scene::Instantiate(const std::string & name, const yoyo::Mat4x4 & transform_matrix, bool* serialize)
+Entity Scene::Instantiate(Tag name, const yoyo::Mat4x4 & transform_matrix)
 {
 	Entity e = {};
 	e = Entity{ m_registry.create(), this };
 
-	e.AddComponent<TagComponent>().tag = name;
+	e.AddComponent<TagComponent>(name);
 
 	TransformComponent& transform = e.AddComponent<TransformComponent>();
 	transform.position = yoyo::PositionFromMat4x4(transform_matrix);
@@ -58,26 +126,405 @@ Entity Scene::Instantiate(const std::string & name, const yoyo::Mat4x4 & transfo
 	return e;
 }
 
+Entity Scene::FindEntityWithTag(Tag tag) const
+{
+	const std::vector<entt::entity>& entities = FindEntitiesWithTag(tag);
+	return entities.empty() ? Entity{} : Entity{ entities.front(), const_cast<Scene*>(this) };
+}
+
+const std::vector<entt::entity>& Scene::FindEntitiesWithTag(Tag tag) const
+{
+	static const std::vector<entt::entity> none;
+
+	auto it = m_tag_index.find(tag);
+	return it != m_tag_index.end() ? it->second : none;
+}
+
+void Scene::SetTag(Entity e, Tag tag)
+{
+	TagComponent& tag_component = m_registry.get<TagComponent>(e);
+	if (tag_component.tag == tag)
+	{
+		return;
+	}
+
+	UnindexTag(tag_component);
+	tag_component.tag = tag;
+	IndexTag(e, tag_component);
+}
+
+void Scene::OnTagCreated(entt::registry& registry, entt::entity id)
+{
+	IndexTag(id, registry.get<TagComponent>(id));
+}
+
+void Scene::OnTagDestroyed(entt::registry& registry, entt::entity id)
+{
+	UnindexTag(registry.get<TagComponent>(id));
+}
+
+void Scene::IndexTag(entt::entity id, TagComponent& tag)
+{
+	std::vector<entt::entity>& entities = m_tag_index[tag.tag];
+	tag.m_index_slot = static_cast<uint32_t>(entities.size());
+	entities.push_back(id);
+}
+
+void Scene::UnindexTag(TagComponent& tag)
+{
+	auto it = m_tag_index.find(tag.tag);
+	YASSERT(it != m_tag_index.end() && tag.m_index_slot < it->second.size(), "Tag missing from scene tag index!");
+
+	// Swap with the last entity of the same tag
+	std::vector<entt::entity>& entities = it->second;
+	entt::entity moved = entities.back();
+	entities[tag.m_index_slot] = moved;
+	m_registry.get<TagComponent>(moved).m_index_slot = tag.m_index_slot;
+	entities.pop_back();
+
+	tag.m_index_slot = UINT32_MAX;
+}
+
 void Scene::QueueDestroy(Entity e) 
 {
-	// TODO: Check if current entity already queued for destruction
-	m_destruction_queue.push_back(e);
+	CommandBuffer().Destroy(e);
 }
 
-void Scene::FlushDestructionQueue() 
+SceneCommandBuffer& Scene::CommandBuffer()
 {
-	for(auto e : m_destruction_queue)
+	// Buffers are cached per thread by scene id, scene addresses may be reused
+	struct CachedBuffer
 	{
-		Destroy(e);
+		uint64_t scene_id;
+		SceneCommandBuffer* buffer;
+	};
+	thread_local std::vector<CachedBuffer> cached_buffers;
+
+	for (const CachedBuffer& cached : cached_buffers)
+	{
+		if (cached.scene_id == m_id)
+		{
+			return *cached.buffer;
+		}
 	}
 
-	m_destruction_queue.clear();
+	std::lock_guard<std::mutex> lock(m_command_buffers_mutex);
+	m_command_buffers.push_back(std::make_unique<SceneCommandBuffer>());
+	cached_buffers.push_back({ m_id, m_command_buffers.back().get() });
+
+	return *m_command_buffers.back();
+}
+
+void Scene::FlushCommandBuffers() 
+{
+	std::vector<SceneCommandBuffer*> buffers;
+	{
+		std::lock_guard<std::mutex> lock(m_command_buffers_mutex);
+		for (auto& buffer : m_command_buffers)
+		{
+			buffers.push_back(buffer.get());
+		}
+	}
+
+	// Playback can record more commands, i.e. scripts queueing destruction as they are created
+	bool played_back = true;
+	while (played_back)
+	{
+		played_back = false;
+		for (SceneCommandBuffer* buffer : buffers)
+		{
+			if (!buffer->Empty())
+			{
+				buffer->Playback(this);
+				played_back = true;
+			}
+		}
+
+		// Everything destroyed this frame goes out in as few batches as possible
+		if (!m_marked.empty() || !m_released.empty())
+		{
+			DestroyMarked();
+			played_back = true;
+		}
+	}
 }
 
 void Scene::Destroy(Entity e) 
 {
-	// TODO: Allow destruction
-	m_registry.destroy(e);
+	MarkForDestruction(e);
+	DestroyMarked();
+}
+
+void Scene::MarkForDestruction(Entity e)
+{
+	if (!m_registry.valid(e))
+	{
+		return;
+	}
+
+	// Pooled instances are returned whole to their pool
+	entt::entity id = e;
+	const PooledComponent* pooled = m_registry.try_get<PooledComponent>(id);
+	if (pooled && pooled->pool)
+	{
+		id = pooled->root;
+	}
+
+	uint32_t index = static_cast<uint32_t>(entt::to_entity(id));
+	if (index >= m_destroy_marks.size())
+	{
+		m_destroy_marks.resize(index + 1, false);
+	}
+
+	if (m_destroy_marks[index])
+	{
+		return;
+	}
+
+	m_destroy_marks[index] = true;
+	if (pooled && pooled->pool)
+	{
+		m_released.push_back(id);
+	}
+	else
+	{
+		m_marked.push_back(id);
+	}
+}
+
+bool Scene::IsMarkedForDestruction(entt::entity id) const
+{
+	uint32_t index = static_cast<uint32_t>(entt::to_entity(id));
+	return index < m_destroy_marks.size() && m_destroy_marks[index];
+}
+
+void Scene::DestroyMarked()
+{
+	// Entities marked by destruction callbacks are picked up by the next batch
+	if (m_destroying)
+	{
+		return;
+	}
+
+	m_destroying = true;
+	while (!m_marked.empty() || !m_released.empty())
+	{
+		// Releasing can queue children attached to pooled instances after they were acquired
+		ReleasePooled();
+		if (m_marked.empty())
+		{
+			continue;
+		}
+
+		m_destroy_batch.clear();
+		std::swap(m_destroy_batch, m_marked);
+
+		// Collect subtrees, children already marked were queued themselves
+		for (size_t i = 0; i < m_destroy_batch.size(); i++)
+		{
+			const TransformComponent* transform = m_registry.try_get<TransformComponent>(m_destroy_batch[i]);
+			if (!transform)
+			{
+				continue;
+			}
+
+			for (Entity child = transform->first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
+			{
+				MarkForDestruction(child);
+			}
+
+			m_destroy_batch.insert(m_destroy_batch.end(), m_marked.begin(), m_marked.end());
+			m_marked.clear();
+		}
+
+		// Pooled children leave their parents before the parents are destroyed
+		ReleasePooled();
+
+		// Detach each subtree from the surviving hierarchy once, then cut the links inside the batch
+		// so per entity destruction callbacks have no hierarchy to walk
+		for (entt::entity id : m_destroy_batch)
+		{
+			if (TransformComponent* transform = m_registry.try_get<TransformComponent>(id))
+			{
+				if (transform->parent && !IsMarkedForDestruction(transform->parent))
+				{
+					transform->parent.GetComponent<TransformComponent>().RemoveChild(transform->self);
+				}
+			}
+		}
+
+		for (entt::entity id : m_destroy_batch)
+		{
+			if (TransformComponent* transform = m_registry.try_get<TransformComponent>(id))
+			{
+				transform->parent = {};
+				transform->first_child = {};
+				transform->last_child = {};
+				transform->next_sibling = {};
+				transform->prev_sibling = {};
+				transform->children_count = 0;
+			}
+		}
+
+		m_destroy_batch_signal.publish(m_destroy_batch);
+		m_registry.destroy(m_destroy_batch.begin(), m_destroy_batch.end());
+
+		for (entt::entity id : m_destroy_batch)
+		{
+			m_destroy_marks[entt::to_entity(id)] = false;
+		}
+	}
+	m_destroying = false;
+}
+
+void Scene::ReleasePooled()
+{
+	while (!m_released.empty())
+	{
+		entt::entity root = m_released.back();
+		m_released.pop_back();
+
+		m_registry.get<PooledComponent>(root).pool->Release(Entity{ root, this });
+		m_destroy_marks[entt::to_entity(root)] = false;
+	}
+}
+
+void Scene::Disable(const std::vector<entt::entity>& entities)
+{
+	m_state_batch.clear();
+	for (entt::entity id : entities)
+	{
+		if (m_registry.valid(id) && IsEnabled(id))
+		{
+			m_state_batch.push_back(id);
+		}
+	}
+
+	if (m_state_batch.empty())
+	{
+		return;
+	}
+
+	m_disable_batch_signal.publish(m_state_batch);
+	m_registry.insert<DisabledComponent>(m_state_batch.begin(), m_state_batch.end());
+}
+
+void Scene::Enable(const std::vector<entt::entity>& entities)
+{
+	m_state_batch.clear();
+	for (entt::entity id : entities)
+	{
+		if (m_registry.valid(id) && !IsEnabled(id))
+		{
+			m_state_batch.push_back(id);
+		}
+	}
+
+	if (m_state_batch.empty())
+	{
+		return;
+	}
+
+	m_registry.remove<DisabledComponent>(m_state_batch.begin(), m_state_batch.end());
+	m_enable_batch_signal.publish(m_state_batch);
+}
+
+bool Scene::IsEnabled(entt::entity id) const
+{
+	return !m_registry.all_of<DisabledComponent>(id);
+}
+
+void Scene::SetEnabled(Entity root, bool enabled)
+{
+	if (!root.IsValid())
+	{
+		return;
+	}
+
+	DisabledComponent* disabled = m_registry.try_get<DisabledComponent>(root);
+	if (enabled)
+	{
+		if (disabled)
+		{
+			disabled->self = false;
+		}
+
+		// Stays disabled until its parent is enabled
+		Entity parent = m_registry.get<TransformComponent>(root).parent;
+		if (parent && !IsEnabled(parent))
+		{
+			return;
+		}
+	}
+
+	// Preorder, parents change state before their children. Subtrees disabled on their own keep their state.
+	m_subtree.clear();
+	m_subtree.push_back(root);
+	for (size_t i = 0; i < m_subtree.size(); i++)
+	{
+		TransformComponent& transform = m_registry.get<TransformComponent>(m_subtree[i]);
+		for (Entity child = transform.first_child; child; child = m_registry.get<TransformComponent>(child).next_sibling)
+		{
+			const DisabledComponent* child_disabled = m_registry.try_get<DisabledComponent>(child);
+			if (!child_disabled || !child_disabled->self)
+			{
+				m_subtree.push_back(child);
+			}
+		}
+	}
+
+	if (enabled)
+	{
+		Enable(m_subtree);
+	}
+	else
+	{
+		Disable(m_subtree);
+		m_registry.get<DisabledComponent>(root).self = true;
+	}
+}
+
+EntityPool& Scene::Pool(const Prefab& prefab)
+{
+	std::unique_ptr<EntityPool>& pool = m_pools[&prefab];
+	if (!pool)
+	{
+		pool = std::make_unique<EntityPool>(this, prefab);
+	}
+
+	return *pool;
+}
+
+void Scene::Snapshot(SceneState& state)
+{
+	state.Clear();
+	state.m_scene_id = m_id;
+
+	for (const SnapshotHandler& handler : m_snapshot_handlers)
+	{
+		handler.capture(m_registry, state);
+	}
+
+	m_snapshot_signal.publish(state);
+}
+
+bool Scene::Restore(const SceneState& state)
+{
+	YASSERT(state.SceneId() == m_id, "Cannot restore state captured from another scene!");
+
+	if (!SameEntities(m_registry, state))
+	{
+		YERROR("Cannot restore scene state, entities were created or destroyed since the snapshot!");
+		return false;
+	}
+
+	for (const SnapshotHandler& handler : m_snapshot_handlers)
+	{
+		handler.restore(m_registry, state);
+	}
+
+	m_restore_signal.publish(state);
+	return true;
 }
 
 entt::registry &Scene::Registry() { return m_registry; }
@@ -1,57 +1,222 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+
+#include <Core/Assert.h>
 #include <Math/Math.h>
 
 #include "Entity.h"
 #include "EntityImpl.h"
+#include "Tag.h"
+#include "SceneCommandBuffer.h"
+#include "SceneState.h"
+#include "ChangeSet.h"
+
+class Prefab;
+class EntityPool;
+struct TagComponent;
+struct DisabledComponent;
+
+// How the components of hot queries are laid out, see Scene::Pack
+enum class SceneStorage : uint8_t
+{
+    Sparse, // Every component type in its own sparse set, queries join them by lookup
+    Packed, // Components of packed queries are kept in the same order at the front of their pools
+};
+
+#ifdef Y_PACKED_STORAGE
+constexpr SceneStorage DEFAULT_SCENE_STORAGE = SceneStorage::Packed;
+#else
+constexpr SceneStorage DEFAULT_SCENE_STORAGE = SceneStorage::Sparse;
+#endif
 
 class Scene
 {
 public:
-    Scene();
+    Scene(SceneStorage storage = DEFAULT_SCENE_STORAGE);
     ~Scene();
 
     Entity Root();
 
+    // Component access does a single lookup, missing components are only checked in debug builds
+
     template <typename T, typename... Args>
     T& AddComponent(entt::entity id, Args &&...args)
     {
-        if (HasComponent<T>(id))
+        return m_registry.get_or_emplace<T>(id, std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename... Args>
+    bool RemoveComponent(entt::entity id, Args &&...args)
+    {
+        return m_registry.remove<T>(id) > 0;
+    }
+
+    template <typename T>
+    bool HasComponent(entt::entity id)
+    {
+        return m_registry.any_of<T>(id);
+    }
+
+    template <typename T>
+    T& GetComponent(entt::entity id)
+    {
+#ifdef Y_DEBUG
+        T* component = m_registry.try_get<T>(id);
+        if (!component)
         {
-            return GetComponent<T>(id);
+            YERROR("Entity has no such component!");
+            throw std::runtime_error("Entity has no such component!");
         }
 
-        return m_registry.emplace<T>(id, std::forward<Args>(args)...);
+        return *component;
+#else
+        return m_registry.get<T>(id);
+#endif
     }
 
-    template <typename T, typename... Args>
-    bool RemoveComponent(entt::entity id, Args &&...args)
+    // Returns null if the entity has no component T
+    template <typename T>
+    T* TryGetComponent(entt::entity id)
+    {
+        return m_registry.try_get<T>(id);
+    }
+
+    // Calls fn(T&...) or fn(entt::entity, T&...) for every enabled entity with all of T
+    template <typename... T, typename Fn>
+    void Each(Fn&& fn)
+    {
+        PartitionKind partition = FindPartition(typeid(PartitionKey<T...>));
+        if constexpr (PackedQuery<TypeList<>, TypeList<>, T...>::PACKABLE)
+        {
+            if (partition == PartitionKind::Packed)
+            {
+                // Owned components are walked in step, the tuple is reordered to T...
+                for (auto&& components : PackedQuery<TypeList<>, TypeList<>, T...>::Group(m_registry).each())
+                {
+                    if constexpr (std::is_invocable_v<Fn, entt::entity, T&...>)
+                    {
+                        fn(std::get<entt::entity>(components), std::get<T&>(components)...);
+                    }
+                    else
+                    {
+                        fn(std::get<T&>(components)...);
+                    }
+                }
+                return;
+            }
+        }
+
+        if (partition == PartitionKind::Partitioned)
+        {
+            m_registry.group<>(entt::get<T...>, entt::exclude<DisabledComponent>).each(fn);
+            return;
+        }
+
+        m_registry.view<T...>(entt::exclude<DisabledComponent>).each(fn);
+    }
+
+    // Keeps the enabled entities with all of T packed apart from disabled ones, Each<T...> then iterates them without testing each entity.
+    // Creating a partition changes the registry, systems partition in OnInit and never during updates.
+    template <typename... T>
+    void Partition()
+    {
+        if (FindPartition(typeid(PartitionKey<T...>)) == PartitionKind::None)
+        {
+            m_registry.group<>(entt::get<T...>, entt::exclude<DisabledComponent>);
+            m_partitions[typeid(PartitionKey<T...>)] = PartitionKind::Partitioned;
+        }
+    }
+
+    // Partitions a hot query, with packed storage its components are also kept in the same order at the front of their pools so Each<T...> reads them in step.
+    // Pointer stable components (in_place_delete) can not be reordered and are looked up, and a component can only be packed by one query.
+    // Each<T...> must list the components in the same order.
+    template <typename... T>
+    void Pack()
+    {
+        static_assert(PackedQuery<TypeList<>, TypeList<>, T...>::PACKABLE, "Packed query owns no components!");
+
+        if (m_storage == SceneStorage::Sparse)
+        {
+            Partition<T...>();
+            return;
+        }
+
+        if (FindPartition(typeid(PartitionKey<T...>)) == PartitionKind::None)
+        {
+            PackedQuery<TypeList<>, TypeList<>, T...>::Group(m_registry);
+            m_partitions[typeid(PartitionKey<T...>)] = PartitionKind::Packed;
+        }
+    }
+
+    SceneStorage Storage() const { return m_storage; }
+
+    // Calls fn(T&) and marks T changed
+    template <typename T, typename Fn>
+    void Patch(entt::entity id, Fn&& fn)
+    {
+        fn(GetComponent<T>(id));
+        MarkChanged<T>(id);
+    }
+
+    // Adds the entities to every set tracking T, safe to call from jobs
+    template <typename T>
+    void MarkChanged(entt::entity id)
     {
-        if (!HasComponent<T>(id))
+        if (ChangeTracker* tracker = FindTracker(typeid(T)))
         {
-            return false;
+            std::lock_guard<std::mutex> lock(tracker->mutex);
+            for (ChangeSet* set : tracker->sets)
+            {
+                set->Add(id);
+            }
         }
+    }
 
-        m_registry.remove<T>(id);
-        return true;
+    template <typename T>
+    void MarkChanged(const std::vector<entt::entity>& ids)
+    {
+        if (ChangeTracker* tracker = FindTracker(typeid(T)))
+        {
+            std::lock_guard<std::mutex> lock(tracker->mutex);
+            for (ChangeSet* set : tracker->sets)
+            {
+                for (entt::entity id : ids)
+                {
+                    set->Add(id);
+                }
+            }
+        }
     }
 
+    // Set receives the entities whose T is marked changed until untracked, systems track and untrack outside of updates
     template <typename T>
-    bool HasComponent(entt::entity id)
+    void Track(ChangeSet& set)
     {
-        return m_registry.any_of<T>(id);
+        m_change_trackers[typeid(T)].sets.push_back(&set);
     }
 
     template <typename T>
-    T& GetComponent(entt::entity id)
+    void Untrack(ChangeSet& set)
     {
-        if (HasComponent<T>(id))
+        if (ChangeTracker* tracker = FindTracker(typeid(T)))
         {
-            return m_registry.get<T>(id);
+            tracker->sets.erase(std::remove(tracker->sets.begin(), tracker->sets.end(), &set), tracker->sets.end());
         }
+    }
 
-        YERROR("Entity has no such component!");
-        throw std::runtime_error("Entity has no such component!");
+    // Producers may skip collecting changes nobody consumes
+    template <typename T>
+    bool IsTracked()
+    {
+        ChangeTracker* tracker = FindTracker(typeid(T));
+        return tracker && !tracker->sets.empty();
     }
 
     template <typename T>
@@ -65,20 +230,332 @@ public:
         return {};
     }
 
+    // Tracks the entities holding T in the order they gained it, so Singleton<T> is a single read.
+    // Registered by systems in OnInit. Entities that already have T are queued ahead of later holders in the registry's view order,
+    // which is arbitrary but stable. Meant for components few entities hold, i.e. cameras.
+    template <typename T>
+    void RegisterSingleton()
+    {
+        SingletonSlot& slot = Slot(SingletonIndex<T>());
+        if (slot.registered)
+        {
+            return;
+        }
+
+        slot.registered = true;
+        m_registry.on_construct<T>().template connect<&Scene::OnSingletonCreated<T>>(this);
+        m_registry.on_destroy<T>().template connect<&Scene::OnSingletonDestroyed<T>>(this);
+
+        auto view = m_registry.view<T>();
+        slot.holders.assign(view.begin(), view.end());
+        slot.entity = slot.holders.empty() ? Entity{} : Entity{ slot.holders.front(), this };
+    }
+
+    // Returns the entity that gained T first among those still holding it, see RegisterSingleton for entities that had T before.
+    // Null if none or if T was never registered. Disabled entities included.
+    // The result only changes when T is removed from that entity, so callers may cache it while it still has T.
+    template <typename T>
+    Entity Singleton() const
+    {
+        uint32_t index = SingletonIndex<T>();
+        YASSERT(index < m_singletons.size() && m_singletons[index].registered, "Singleton component was not registered!");
+        if (index >= m_singletons.size())
+        {
+            return {};
+        }
+
+        return m_singletons[index].entity;
+    }
+
     // Create and returns entity
-    Entity Instantiate(const std::string& name = "", const yoyo::Vec3& position = {}, bool* serialize = nullptr);
-    Entity Instantiate(const std::string& name = "", const yoyo::Mat4x4& transform_matrix = {}, bool* serialize = nullptr);
+    Entity Instantiate(Tag name = {}, const yoyo::Vec3& position = {});
+    Entity Instantiate(Tag name = {}, const yoyo::Mat4x4& transform_matrix = {});
+
+    // Returns an entity tagged tag, disabled entities included
+    Entity FindEntityWithTag(Tag tag) const;
 
-    // Queues an entity for destruction
+    // Returns every entity tagged tag, invalidated by structural changes
+    const std::vector<entt::entity>& FindEntitiesWithTag(Tag tag) const;
+
+    void SetTag(Entity e, Tag tag);
+
+    // Queues an entity for destruction on the calling thread's command buffer
     void QueueDestroy(Entity e);
 
-    void FlushDestructionQueue();
+    // Returns the calling thread's command buffer, structural changes recorded here are applied by FlushCommandBuffers
+    SceneCommandBuffer& CommandBuffer();
+
+    // Plays back every thread's command buffer, must not be called while systems iterate the scene
+    void FlushCommandBuffers();
 
+    // Destroys e and its children
     void Destroy(Entity e);
 
+    // Signal published with every entity of a destruction batch, before any of their components are destroyed
+    entt::sink<entt::sigh<void(const std::vector<entt::entity>&)>> OnDestroyBatch() { return entt::sink{ m_destroy_batch_signal }; }
+
+    // Disabled entities keep their components but systems skip them and withdraw them from physics and rendering
+    void Disable(const std::vector<entt::entity>& entities);
+    void Enable(const std::vector<entt::entity>& entities);
+    bool IsEnabled(entt::entity id) const;
+
+    // Disables or enables root and its descendants, systems record this on their command buffer during updates.
+    // Entities are enabled if they and all of their ancestors are, descendants disabled on their own stay disabled with their subtree.
+    void SetEnabled(Entity root, bool enabled);
+
+    // Signals published with the entities whose state changed, disable before and enable after the change
+    entt::sink<entt::sigh<void(const std::vector<entt::entity>&)>> OnDisableBatch() { return entt::sink{ m_disable_batch_signal }; }
+    entt::sink<entt::sigh<void(const std::vector<entt::entity>&)>> OnEnableBatch() { return entt::sink{ m_enable_batch_signal }; }
+
+    // Signal published with the nodes of a parked pool instance once Acquire has enabled them again, systems reset state left from its last use
+    entt::sink<entt::sigh<void(const std::vector<entt::entity>&)>> OnAcquireBatch() { return entt::sink{ m_acquire_batch_signal }; }
+
+    // Returns the scene's pool of prefab instances, created on first use. The prefab must outlive the scene.
+    EntityPool& Pool(const Prefab& prefab);
+
+    // Copies transforms, snapshot components and the state of systems listening to OnSnapshot into state.
+    // Restore writes it back to the same entities. Entities are not recreated, so Restore returns false and leaves the scene untouched
+    // when any entity was created or destroyed since the snapshot, an entity destroyed and recreated in the same slot included.
+    void Snapshot(SceneState& state);
+    bool Restore(const SceneState& state);
+
+    // T is copied whole by Snapshot and assigned back by Restore
+    template <typename T>
+    void RegisterSnapshotComponent()
+    {
+        for (const SnapshotHandler& handler : m_snapshot_handlers)
+        {
+            if (handler.capture == &CaptureComponents<T>)
+            {
+                return;
+            }
+        }
+
+        m_snapshot_handlers.push_back({ &CaptureComponents<T>, &RestoreComponents<T> });
+    }
+
+    // Signals published after the scene's components are captured and restored, systems keep their own records in the state
+    entt::sink<entt::sigh<void(SceneState&)>> OnSnapshot() { return entt::sink{ m_snapshot_signal }; }
+    entt::sink<entt::sigh<void(const SceneState&)>> OnRestore() { return entt::sink{ m_restore_signal }; }
+
     entt::registry& Registry();
 private:
-    std::vector<Entity> m_destruction_queue;
+    friend class SceneCommandBuffer;
+    friend class EntityPool;
+
+    template <typename... T>
+    struct PartitionKey {};
+
+    enum class PartitionKind : uint8_t
+    {
+        None,
+        Partitioned,
+        Packed,
+    };
+
+    PartitionKind FindPartition(std::type_index key) const
+    {
+        auto it = m_partitions.find(key);
+        return it != m_partitions.end() ? it->second : PartitionKind::None;
+    }
+
+    template <typename... T>
+    struct TypeList {};
+
+    // Stable components keep their address until destroyed and can not be owned by a group
+    template <typename T, typename = void>
+    struct IsStable : std::false_type {};
+
+    template <typename T>
+    struct IsStable<T, std::void_t<decltype(T::in_place_delete)>> : std::bool_constant<T::in_place_delete> {};
+
+    // Splits T... into the components a group owns and the ones it looks up
+    template <typename Owned, typename Get, typename... T>
+    struct PackedQuery;
+
+    template <typename... Owned, typename... Get>
+    struct PackedQuery<TypeList<Owned...>, TypeList<Get...>>
+    {
+        static constexpr bool PACKABLE = sizeof...(Owned) > 0;
+
+        static auto Group(entt::registry& registry)
+        {
+            return registry.group<Owned...>(entt::get<Get...>, entt::exclude<DisabledComponent>);
+        }
+    };
+
+    template <typename... Owned, typename... Get, typename T, typename... Rest>
+    struct PackedQuery<TypeList<Owned...>, TypeList<Get...>, T, Rest...>
+        : std::conditional_t<IsStable<T>::value,
+            PackedQuery<TypeList<Owned...>, TypeList<Get..., T>, Rest...>,
+            PackedQuery<TypeList<Owned..., T>, TypeList<Get...>, Rest...>> {};
+
+    template <typename T>
+    struct ComponentRecord
+    {
+        entt::entity id;
+        T component;
+    };
+
+    template <typename T>
+    static void CaptureComponents(entt::registry& registry, SceneState& state)
+    {
+        std::vector<ComponentRecord<T>>& records = state.Records<ComponentRecord<T>>();
+        registry.view<T>().each([&](entt::entity id, const T& component) {
+            records.push_back({ id, component });
+        });
+    }
+
+    template <typename T>
+    static void RestoreComponents(entt::registry& registry, const SceneState& state)
+    {
+        const std::vector<ComponentRecord<T>>* records = state.Find<ComponentRecord<T>>();
+        if (!records)
+        {
+            return;
+        }
+
+        for (const ComponentRecord<T>& record : *records)
+        {
+            if (T* component = registry.valid(record.id) ? registry.try_get<T>(record.id) : nullptr)
+            {
+                *component = record.component;
+            }
+        }
+    }
+
+    struct ChangeTracker
+    {
+        std::mutex mutex;
+        std::vector<ChangeSet*> sets;
+    };
+
+    ChangeTracker* FindTracker(std::type_index type)
+    {
+        auto it = m_change_trackers.find(type);
+        return it != m_change_trackers.end() ? &it->second : nullptr;
+    }
+
+    struct SingletonSlot
+    {
+        // Front of holders
+        Entity entity;
+
+        // Entities holding T, oldest first
+        std::vector<entt::entity> holders;
+        bool registered = false;
+    };
+
+    static uint32_t NextSingletonIndex()
+    {
+        static std::atomic<uint32_t> s_next_index = 0;
+        return s_next_index++;
+    }
+
+    template <typename T>
+    static uint32_t SingletonIndex()
+    {
+        static const uint32_t s_index = NextSingletonIndex();
+        return s_index;
+    }
+
+    SingletonSlot& Slot(uint32_t index)
+    {
+        if (index >= m_singletons.size())
+        {
+            m_singletons.resize(index + 1);
+        }
+
+        return m_singletons[index];
+    }
+
+    template <typename T>
+    void OnSingletonCreated(entt::registry& registry, entt::entity id)
+    {
+        SingletonSlot& slot = m_singletons[SingletonIndex<T>()];
+        slot.holders.push_back(id);
+        if (!slot.entity)
+        {
+            slot.entity = Entity{ id, this };
+        }
+    }
+
+    // Hands the singleton to the oldest remaining holder, called before T is removed from id
+    template <typename T>
+    void OnSingletonDestroyed(entt::registry& registry, entt::entity id)
+    {
+        SingletonSlot& slot = m_singletons[SingletonIndex<T>()];
+
+        auto it = std::find(slot.holders.begin(), slot.holders.end(), id);
+        if (it != slot.holders.end())
+        {
+            slot.holders.erase(it);
+        }
+
+        slot.entity = slot.holders.empty() ? Entity{} : Entity{ slot.holders.front(), this };
+    }
+
+    struct SnapshotHandler
+    {
+        void (*capture)(entt::registry& registry, SceneState& state);
+        void (*restore)(entt::registry& registry, const SceneState& state);
+    };
+
+    // Marks e for destruction by the next DestroyMarked, entities already marked are ignored
+    void MarkForDestruction(Entity e);
+    bool IsMarkedForDestruction(entt::entity id) const;
+
+    // Destroys marked entities and their subtrees in batches
+    void DestroyMarked();
+
+    // Returns pooled instances queued for destruction to their pools
+    void ReleasePooled();
+
+    // Keep the tag index in sync with TagComponents
+    void OnTagCreated(entt::registry& registry, entt::entity id);
+    void OnTagDestroyed(entt::registry& registry, entt::entity id);
+
+    void IndexTag(entt::entity id, TagComponent& tag);
+    void UnindexTag(TagComponent& tag);
+private:
+    uint64_t m_id;
+    SceneStorage m_storage;
+
+    // Written by Partition and Pack outside of updates, read by Each from jobs
+    std::unordered_map<std::type_index, PartitionKind> m_partitions;
+
+    // Indexed by entity index, set while the entity is marked for destruction
+    std::vector<bool> m_destroy_marks;
+    std::vector<entt::entity> m_marked;
+    std::vector<entt::entity> m_destroy_batch;
+    bool m_destroying = false;
+    entt::sigh<void(const std::vector<entt::entity>&)> m_destroy_batch_signal;
+
+    // Roots of pooled instances marked for destruction
+    std::vector<entt::entity> m_released;
+
+    std::vector<entt::entity> m_state_batch;
+    std::vector<entt::entity> m_subtree;
+    entt::sigh<void(const std::vector<entt::entity>&)> m_disable_batch_signal;
+    entt::sigh<void(const std::vector<entt::entity>&)> m_enable_batch_signal;
+    entt::sigh<void(const std::vector<entt::entity>&)> m_acquire_batch_signal;
+
+    std::mutex m_command_buffers_mutex;
+    std::vector<std::unique_ptr<SceneCommandBuffer>> m_command_buffers;
+
+    std::unordered_map<Tag, std::vector<entt::entity>> m_tag_index;
+
     Entity m_root;
     entt::registry m_registry;
+
+    std::unordered_map<const Prefab*, std::unique_ptr<EntityPool>> m_pools;
+
+    std::unordered_map<std::type_index, ChangeTracker> m_change_trackers;
+
+    // Indexed by SingletonIndex
+    std::vector<SingletonSlot> m_singletons;
+
+    std::vector<SnapshotHandler> m_snapshot_handlers;
+    entt::sigh<void(SceneState&)> m_snapshot_signal;
+    entt::sigh<void(const SceneState&)> m_restore_signal;
 };
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "SceneCommandBuffer.h"
+
+#include "Scene.h"
+#include "EntityPool.h"
+#include "Prefab.h"
+#include "Components/Components.h"
+
+DeferredEntity SceneCommandBuffer::Instantiate(Tag name, const yoyo::Vec3& position)
+{
+	DeferredEntity e = { m_instantiate_count++ };
+	m_commands.push_back([name, position](Scene* scene, std::vector<Entity>& created)
+	{
+		created.push_back(scene->Instantiate(name, position));
+	});
+
+	return e;
+}
+
+DeferredEntity SceneCommandBuffer::Instantiate(Tag name, const yoyo::Mat4x4& transform_matrix)
+{
+	DeferredEntity e = { m_instantiate_count++ };
+	m_commands.push_back([name, transform_matrix](Scene* scene, std::vector<Entity>& created)
+	{
+		created.push_back(scene->Instantiate(name, transform_matrix));
+	});
+
+	return e;
+}
+
+DeferredEntity SceneCommandBuffer::Acquire(EntityPool& pool, const yoyo::Vec3& position)
+{
+	DeferredEntity e = { m_instantiate_count++ };
+	m_commands.push_back([&pool, position](Scene* scene, std::vector<Entity>& created)
+	{
+		created.push_back(pool.Acquire(position));
+	});
+
+	return e;
+}
+
+void SceneCommandBuffer::Instantiate(const Prefab& prefab, std::vector<yoyo::Vec3> positions)
+{
+	m_commands.push_back([&prefab, positions = std::move(positions)](Scene* scene, std::vector<Entity>& created)
+	{
+		prefab.Instantiate(scene, positions);
+	});
+}
+
+void SceneCommandBuffer::Destroy(Entity e)
+{
+	m_commands.push_back([e](Scene* scene, std::vector<Entity>& created)
+	{
+		scene->MarkForDestruction(e);
+	});
+}
+
+void SceneCommandBuffer::Playback(Scene* scene)
+{
+	// Commands recorded during playback, i.e. from component callbacks, go to the next playback
+	std::swap(m_commands, m_playback_commands);
+	m_instantiate_count = 0;
+
+	m_created.clear();
+	for (Command& command : m_playback_commands)
+	{
+		command(scene, m_created);
+	}
+
+	m_playback_commands.clear();
+}
+
+void SceneCommandBuffer::LinkChild(Entity parent, Entity child)
+{
+	if (parent.IsValid() && child.IsValid())
+	{
+		parent.GetComponent<TransformComponent>().AddChild(child);
+	}
+}
+
+void SceneCommandBuffer::ApplyEnabled(Scene* scene, Entity e, bool enabled)
+{
+	scene->SetEnabled(e, enabled);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <Math/Math.h>
+
+#include "Entity.h"
+#include "Tag.h"
+
+class EntityPool;
+class Prefab;
+
+// Entity recorded in a command buffer, resolved to an Entity on playback
+struct DeferredEntity
+{
+    uint32_t index = UINT32_MAX;
+};
+
+// Records structural changes (instantiate, add component, parent, enable, destroy) and applies them to the scene in order on playback.
+// Component constructor arguments of type DeferredEntity are resolved to the created Entity.
+class SceneCommandBuffer
+{
+public:
+    SceneCommandBuffer() = default;
+    ~SceneCommandBuffer() = default;
+
+    DeferredEntity Instantiate(Tag name = {}, const yoyo::Vec3& position = {});
+    DeferredEntity Instantiate(Tag name, const yoyo::Mat4x4& transform_matrix);
+
+    // Acquires an instance from pool, see EntityPool::Acquire
+    DeferredEntity Acquire(EntityPool& pool, const yoyo::Vec3& position = {});
+
+    // Instantiates one instance of prefab per position as one wave, see Prefab::Instantiate. The prefab must outlive the playback.
+    void Instantiate(const Prefab& prefab, std::vector<yoyo::Vec3> positions);
+
+    // Adds component T with copies of args, e may be an Entity or a DeferredEntity
+    template<typename T, typename Target, typename... Args>
+    void AddComponent(const Target& e, Args&&... args)
+    {
+        m_commands.push_back([e, args = std::make_tuple(std::forward<Args>(args)...)](Scene* scene, std::vector<Entity>& created) mutable
+        {
+            Entity entity = Resolve(e, created);
+            if (!entity.IsValid())
+            {
+                return;
+            }
+
+            std::apply([&](auto&... arg) { entity.template AddComponent<T>(Resolve(arg, created)...); }, args);
+        });
+    }
+
+    // Calls fn with the entity's component T once the commands before it have been played back
+    template<typename T, typename Target, typename Fn>
+    void Configure(const Target& e, Fn fn)
+    {
+        m_commands.push_back([e, fn](Scene* scene, std::vector<Entity>& created) mutable
+        {
+            Entity entity = Resolve(e, created);
+            if (entity.IsValid() && entity.template HasComponent<T>())
+            {
+                fn(entity.template GetComponent<T>());
+            }
+        });
+    }
+
+    template<typename Parent, typename Child>
+    void AddChild(const Parent& parent, const Child& child)
+    {
+        m_commands.push_back([parent, child](Scene* scene, std::vector<Entity>& created)
+        {
+            LinkChild(Resolve(parent, created), Resolve(child, created));
+        });
+    }
+
+    // Disables or enables e and its children, see Scene::SetEnabled
+    template<typename Target>
+    void SetEnabled(const Target& e, bool enabled)
+    {
+        m_commands.push_back([e, enabled](Scene* scene, std::vector<Entity>& created)
+        {
+            ApplyEnabled(scene, Resolve(e, created), enabled);
+        });
+    }
+
+    // Destroys e and its children at the end of playback, duplicates and entities destroyed earlier are skipped
+    void Destroy(Entity e);
+
+    // Applies and clears all recorded commands
+    void Playback(Scene* scene);
+
+    bool Empty() const { return m_commands.empty(); }
+private:
+    using Command = std::function<void(Scene* scene, std::vector<Entity>& created)>;
+
+    static Entity Resolve(const DeferredEntity& e, const std::vector<Entity>& created) { return created[e.index]; }
+
+    template<typename T>
+    static const T& Resolve(const T& arg, const std::vector<Entity>& created) { return arg; }
+
+    static void LinkChild(Entity parent, Entity child);
+    static void ApplyEnabled(Scene* scene, Entity e, bool enabled);
+private:
+    std::vector<Command> m_commands;
+    std::vector<Command> m_playback_commands;
+
+    // Entities created by Instantiate commands in record order
+    uint32_t m_instantiate_count = 0;
+    std::vector<Entity> m_created;
+};
@@ -0,0 +1,746 @@
+#include "SceneSnapshot.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <Core/Log.h>
+#include <Resource/ResourceManager.h>
+#include <Renderer/Material.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Light.h>
+
+#include "Scene.h"
+#include "Components/Components.h"
+#include "Components/RenderableComponents.h"
+
+static const uint32_t NO_PARENT = UINT32_MAX;
+
+// Records only hold 4 byte fields so blocks can be read in place from any 4 byte aligned address
+
+struct SnapshotHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entity_count;
+	uint32_t string_count;
+	uint32_t string_bytes; // Padded to 4 bytes
+	uint32_t section_count;
+};
+
+// Local transform of an entity, parent indexes the entity records
+struct EntityRecord
+{
+	uint32_t tag;
+	uint32_t parent;
+
+	float position[3];
+	float rotation[4];
+	float scale[3];
+};
+
+enum class SectionType : uint32_t
+{
+	MeshRenderer = 1,
+	Camera,
+	DirectionalLight,
+};
+
+// Followed by count entity indices and count records of stride bytes, unknown types are skipped
+struct SectionHeader
+{
+	uint32_t type;
+	uint32_t count;
+	uint32_t stride;
+};
+
+// Asset names index the string table
+struct MeshRendererRecord
+{
+	uint32_t mesh;
+	uint32_t material;
+	uint32_t type;
+};
+
+struct CameraRecord
+{
+	uint32_t type;
+	uint32_t active;
+};
+
+struct DirectionalLightRecord
+{
+	float color[4];
+	float direction[4];
+};
+
+class SnapshotWriter
+{
+public:
+	SnapshotWriter(std::vector<uint8_t>& out)
+		:m_out(out) {}
+
+	template<typename T>
+	void Write(const T& value)
+	{
+		WriteBytes(&value, sizeof(T));
+	}
+
+	void WriteBytes(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		m_out.insert(m_out.end(), bytes, bytes + size);
+	}
+private:
+	std::vector<uint8_t>& m_out;
+};
+
+// Tags and asset names written once, index 0 is the empty string
+class StringTable
+{
+public:
+	StringTable()
+	{
+		Intern({});
+	}
+
+	uint32_t Intern(const std::string& str)
+	{
+		auto it = m_indices.find(str);
+		if (it != m_indices.end())
+		{
+			return it->second;
+		}
+
+		const uint32_t index = static_cast<uint32_t>(m_strings.size());
+		m_strings.push_back(str);
+		m_indices.emplace(str, index);
+
+		return index;
+	}
+
+	const std::vector<std::string>& Strings() const { return m_strings; }
+private:
+	std::vector<std::string> m_strings;
+	std::unordered_map<std::string, uint32_t> m_indices;
+};
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(const uint8_t* data, size_t size)
+		:m_data(data), m_size(size) {}
+
+	// Returns a pointer to count Ts in the data and advances past them, null if the data is too short
+	template<typename T>
+	const T* Read(size_t count = 1)
+	{
+		static_assert(sizeof(T) % 4 == 0, "Snapshot blocks must stay 4 byte aligned!");
+		return reinterpret_cast<const T*>(ReadBytes(count * sizeof(T)));
+	}
+
+	const uint8_t* ReadBytes(size_t size)
+	{
+		if (size > m_size - m_offset)
+		{
+			return nullptr;
+		}
+
+		const uint8_t* bytes = m_data + m_offset;
+		m_offset += size;
+
+		return bytes;
+	}
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+	size_t m_offset = 0;
+};
+
+template<typename Record>
+static void WriteSection(SnapshotWriter& writer, SectionType type, const std::vector<uint32_t>& indices, const std::vector<Record>& records)
+{
+	SectionHeader header = {};
+	header.type = static_cast<uint32_t>(type);
+	header.count = static_cast<uint32_t>(records.size());
+	header.stride = sizeof(Record);
+
+	writer.Write(header);
+	writer.WriteBytes(indices.data(), indices.size() * sizeof(uint32_t));
+	writer.WriteBytes(records.data(), records.size() * sizeof(Record));
+}
+
+// Collects the records of every entity in the snapshot that has T, in storage order
+template<typename T, typename Record, typename Fn>
+static void CollectSection(entt::registry& registry, const std::unordered_map<entt::entity, uint32_t>& entity_indices,
+	std::vector<uint32_t>& indices, std::vector<Record>& records, Fn fn)
+{
+	for (entt::entity id : registry.view<T>())
+	{
+		auto it = entity_indices.find(id);
+		if (it == entity_indices.end())
+		{
+			continue;
+		}
+
+		indices.push_back(it->second);
+		records.push_back(fn(registry.get<T>(id)));
+	}
+}
+
+void SceneSnapshot::Write(Scene* scene, std::vector<uint8_t>& out)
+{
+	entt::registry& registry = scene->Registry();
+
+	// Preorder walk from the root so parents are written before their children
+	std::vector<entt::entity> entities;
+	std::vector<uint32_t> parents;
+	std::unordered_map<entt::entity, uint32_t> entity_indices;
+
+	std::vector<std::pair<Entity, uint32_t>> stack;
+	std::vector<Entity> children;
+
+	auto push_children = [&](Entity e, uint32_t index)
+	{
+		children.clear();
+		for (Entity child = e.GetComponent<TransformComponent>().first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
+		{
+			children.push_back(child);
+		}
+
+		// Reversed so siblings are popped in order
+		for (auto it = children.rbegin(); it != children.rend(); it++)
+		{
+			stack.push_back({ *it, index });
+		}
+	};
+
+	push_children(scene->Root(), NO_PARENT);
+	while (!stack.empty())
+	{
+		auto [e, parent] = stack.back();
+		stack.pop_back();
+
+		const uint32_t index = static_cast<uint32_t>(entities.size());
+		entities.push_back(e);
+		parents.push_back(parent);
+		entity_indices.emplace(e, index);
+
+		push_children(e, index);
+	}
+
+	StringTable string_table;
+
+	std::vector<uint8_t> body;
+	SnapshotWriter writer(body);
+
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		const TagComponent* tag = registry.try_get<TagComponent>(entities[i]);
+		const TransformComponent& transform = registry.get<TransformComponent>(entities[i]);
+
+		EntityRecord record = {};
+		record.tag = tag ? string_table.Intern(tag->tag.Str()) : 0;
+		record.parent = parents[i];
+
+		record.position[0] = transform.position.x;
+		record.position[1] = transform.position.y;
+		record.position[2] = transform.position.z;
+
+		record.rotation[0] = transform.quat_rotation.x;
+		record.rotation[1] = transform.quat_rotation.y;
+		record.rotation[2] = transform.quat_rotation.z;
+		record.rotation[3] = transform.quat_rotation.w;
+
+		record.scale[0] = transform.scale.x;
+		record.scale[1] = transform.scale.y;
+		record.scale[2] = transform.scale.z;
+
+		writer.Write(record);
+	}
+
+	// Written after the string table but collected first since they intern asset names
+	std::vector<uint8_t> sections;
+	SnapshotWriter section_writer(sections);
+	uint32_t section_count = 0;
+	{
+		std::vector<uint32_t> indices;
+		std::vector<MeshRendererRecord> records;
+		CollectSection<MeshRendererComponent>(registry, entity_indices, indices, records, [&](const MeshRendererComponent& mesh_renderer)
+		{
+			const Ref<yoyo::IMesh>& mesh = mesh_renderer.GetMesh();
+			const Ref<yoyo::Material>& material = mesh_renderer.GetMaterial();
+
+			MeshRendererRecord record = {};
+			record.mesh = mesh ? string_table.Intern(mesh->name) : 0;
+			record.material = material ? string_table.Intern(material->name) : 0;
+			record.type = static_cast<uint32_t>(mesh_renderer.type);
+			return record;
+		});
+
+		if (!records.empty())
+		{
+			WriteSection(section_writer, SectionType::MeshRenderer, indices, records);
+			section_count++;
+		}
+	}
+
+	{
+		std::vector<uint32_t> indices;
+		std::vector<CameraRecord> records;
+		CollectSection<CameraComponent>(registry, entity_indices, indices, records, [](const CameraComponent& camera)
+		{
+			CameraRecord record = {};
+			record.type = camera.camera ? static_cast<uint32_t>(camera.camera->GetType()) : static_cast<uint32_t>(yoyo::CameraType::Perspective);
+			record.active = camera.active ? 1 : 0;
+			return record;
+		});
+
+		if (!records.empty())
+		{
+			WriteSection(section_writer, SectionType::Camera, indices, records);
+			section_count++;
+		}
+	}
+
+	{
+		std::vector<uint32_t> indices;
+		std::vector<DirectionalLightRecord> records;
+		CollectSection<DirectionalLightComponent>(registry, entity_indices, indices, records, [](const DirectionalLightComponent& light)
+		{
+			DirectionalLightRecord record = {};
+			if (light.dir_light)
+			{
+				const yoyo::Vec4& color = light.dir_light->color;
+				const yoyo::Vec4& direction = light.dir_light->direction;
+
+				record.color[0] = color.x; record.color[1] = color.y; record.color[2] = color.z; record.color[3] = color.w;
+				record.direction[0] = direction.x; record.direction[1] = direction.y; record.direction[2] = direction.z; record.direction[3] = direction.w;
+			}
+			return record;
+		});
+
+		if (!records.empty())
+		{
+			WriteSection(section_writer, SectionType::DirectionalLight, indices, records);
+			section_count++;
+		}
+	}
+
+	const std::vector<std::string>& strings = string_table.Strings();
+
+	std::vector<uint32_t> string_offsets;
+	std::vector<uint8_t> string_bytes;
+	for (const std::string& str : strings)
+	{
+		string_offsets.push_back(static_cast<uint32_t>(string_bytes.size()));
+		string_bytes.insert(string_bytes.end(), str.begin(), str.end());
+		string_bytes.push_back(0);
+	}
+	string_bytes.resize((string_bytes.size() + 3) & ~size_t(3), 0);
+
+	SnapshotHeader header = {};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.entity_count = static_cast<uint32_t>(entities.size());
+	header.string_count = static_cast<uint32_t>(strings.size());
+	header.string_bytes = static_cast<uint32_t>(string_bytes.size());
+	header.section_count = section_count;
+
+	SnapshotWriter file_writer(out);
+	file_writer.Write(header);
+	file_writer.WriteBytes(body.data(), body.size());
+	file_writer.WriteBytes(string_offsets.data(), string_offsets.size() * sizeof(uint32_t));
+	file_writer.WriteBytes(string_bytes.data(), string_bytes.size());
+	file_writer.WriteBytes(sections.data(), sections.size());
+}
+
+// Section read in place, records may be larger than the record type read from them
+struct SectionView
+{
+	const SectionHeader* header;
+	const uint32_t* indices;
+	const uint8_t* records;
+
+	template<typename Record>
+	const Record& At(uint32_t i) const { return *reinterpret_cast<const Record*>(records + size_t(i) * header->stride); }
+};
+
+static uint32_t MinStride(SectionType type)
+{
+	switch (type)
+	{
+	case SectionType::MeshRenderer: return sizeof(MeshRendererRecord);
+	case SectionType::Camera: return sizeof(CameraRecord);
+	case SectionType::DirectionalLight: return sizeof(DirectionalLightRecord);
+	default: return 0;
+	}
+}
+
+static bool InvalidSnapshot(const char* reason)
+{
+	YERROR("Invalid scene snapshot: %s!", reason);
+	return false;
+}
+
+bool SceneSnapshot::Read(Scene* scene, const uint8_t* data, size_t size)
+{
+	YASSERT(scene, "Cannot read snapshot into null scene!");
+
+	SnapshotReader reader(data, size);
+
+	const SnapshotHeader* header = reader.Read<SnapshotHeader>();
+	if (!header || header->magic != MAGIC)
+	{
+		return InvalidSnapshot("bad header");
+	}
+
+	if (header->version != VERSION)
+	{
+		YERROR("Scene snapshot version %u does not match version %u!", header->version, VERSION);
+		return false;
+	}
+
+	const EntityRecord* records = reader.Read<EntityRecord>(header->entity_count);
+	const uint32_t* string_offsets = reader.Read<uint32_t>(header->string_count);
+	const uint8_t* string_bytes = reader.ReadBytes(header->string_bytes);
+	if (!records || !string_offsets || !string_bytes || header->string_count == 0 || header->string_bytes % 4 != 0)
+	{
+		return InvalidSnapshot("truncated");
+	}
+
+	// Strings are read in place, the last byte is always a terminator or padding
+	if (string_bytes[header->string_bytes - 1] != 0)
+	{
+		return InvalidSnapshot("unterminated string table");
+	}
+
+	std::vector<std::string_view> strings(header->string_count);
+	for (uint32_t i = 0; i < header->string_count; i++)
+	{
+		if (string_offsets[i] >= header->string_bytes)
+		{
+			return InvalidSnapshot("bad string offset");
+		}
+
+		strings[i] = reinterpret_cast<const char*>(string_bytes + string_offsets[i]);
+	}
+
+	for (uint32_t i = 0; i < header->entity_count; i++)
+	{
+		if (records[i].tag >= header->string_count || (records[i].parent != NO_PARENT && records[i].parent >= i))
+		{
+			return InvalidSnapshot("bad entity record");
+		}
+	}
+
+	// Sections are validated before anything is created so a bad snapshot leaves the scene untouched.
+	// Components are emplaced once per entity, so known types appear in one section and entities once per section.
+	std::vector<SectionView> sections;
+	std::vector<uint32_t> section_of_entity(header->entity_count, 0);
+	uint32_t known_types = 0;
+	for (uint32_t s = 0; s < header->section_count; s++)
+	{
+		SectionView view = {};
+		view.header = reader.Read<SectionHeader>();
+		if (!view.header || view.header->stride % 4 != 0 || view.header->stride < MinStride(static_cast<SectionType>(view.header->type)))
+		{
+			return InvalidSnapshot("bad section");
+		}
+
+		const bool known = MinStride(static_cast<SectionType>(view.header->type)) != 0;
+		if (known)
+		{
+			const uint32_t type_bit = 1u << view.header->type;
+			if (known_types & type_bit)
+			{
+				return InvalidSnapshot("duplicate section");
+			}
+			known_types |= type_bit;
+		}
+
+		view.indices = reader.Read<uint32_t>(view.header->count);
+		view.records = reader.ReadBytes(size_t(view.header->count) * view.header->stride);
+		if (!view.indices || !view.records)
+		{
+			return InvalidSnapshot("truncated section");
+		}
+
+		for (uint32_t i = 0; i < view.header->count; i++)
+		{
+			if (view.indices[i] >= header->entity_count)
+			{
+				return InvalidSnapshot("bad section entity");
+			}
+
+			if (known)
+			{
+				if (section_of_entity[view.indices[i]] == s + 1)
+				{
+					return InvalidSnapshot("duplicate section entity");
+				}
+				section_of_entity[view.indices[i]] = s + 1;
+			}
+
+			if (static_cast<SectionType>(view.header->type) == SectionType::MeshRenderer)
+			{
+				const MeshRendererRecord& record = view.At<MeshRendererRecord>(i);
+				if (record.mesh >= header->string_count || record.material >= header->string_count)
+				{
+					return InvalidSnapshot("bad asset name");
+				}
+			}
+		}
+
+		sections.push_back(view);
+	}
+
+	entt::registry& registry = scene->Registry();
+
+	std::vector<entt::entity> ids(header->entity_count);
+	registry.create(ids.begin(), ids.end());
+
+	for (uint32_t i = 0; i < header->entity_count; i++)
+	{
+		registry.emplace<TagComponent>(ids[i], Tag(strings[records[i].tag]));
+	}
+
+	for (uint32_t i = 0; i < header->entity_count; i++)
+	{
+		const EntityRecord& record = records[i];
+
+		TransformComponent& transform = registry.emplace<TransformComponent>(ids[i]);
+		transform.position = { record.position[0], record.position[1], record.position[2] };
+		transform.quat_rotation = { record.rotation[0], record.rotation[1], record.rotation[2], record.rotation[3] };
+		transform.scale = { record.scale[0], record.scale[1], record.scale[2] };
+	}
+
+	// Subtrees are linked before they are attached to the scene root, so the scene graph only sees whole subtrees
+	for (uint32_t i = 0; i < header->entity_count; i++)
+	{
+		if (records[i].parent != NO_PARENT)
+		{
+			Entity{ ids[records[i].parent], scene }.GetComponent<TransformComponent>().AddChild(Entity{ ids[i], scene });
+		}
+	}
+
+	Entity root = scene->Root();
+	for (uint32_t i = 0; i < header->entity_count; i++)
+	{
+		if (records[i].parent == NO_PARENT)
+		{
+			root.GetComponent<TransformComponent>().AddChild(Entity{ ids[i], scene });
+		}
+	}
+
+	// Assets are resolved once per name
+	std::vector<Ref<yoyo::IMesh>> meshes(header->string_count);
+	std::vector<Ref<yoyo::Material>> materials(header->string_count);
+
+	for (const SectionView& view : sections)
+	{
+		const SectionHeader* section = view.header;
+
+		switch (static_cast<SectionType>(section->type))
+		{
+		case SectionType::MeshRenderer:
+		{
+			for (uint32_t i = 0; i < section->count; i++)
+			{
+				const MeshRendererRecord& record = view.At<MeshRendererRecord>(i);
+
+				const yoyo::MeshType type = static_cast<yoyo::MeshType>(record.type);
+
+				Ref<yoyo::IMesh>& mesh = meshes[record.mesh];
+				if (!mesh && record.mesh != 0)
+				{
+					const std::string name(strings[record.mesh]);
+					if (type == yoyo::MeshType::Skinned)
+					{
+						mesh = yoyo::ResourceManager::Instance().Load<yoyo::SkinnedMesh>(name);
+					}
+					else
+					{
+						mesh = yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>(name);
+					}
+				}
+
+				Ref<yoyo::Material>& material = materials[record.material];
+				if (!material && record.material != 0)
+				{
+					material = yoyo::ResourceManager::Instance().Load<yoyo::Material>(std::string(strings[record.material]));
+				}
+
+				MeshRendererComponent& mesh_renderer = registry.emplace<MeshRendererComponent>(ids[view.indices[i]]);
+				mesh_renderer.type = type;
+				mesh_renderer.SetMesh(mesh);
+				mesh_renderer.SetMaterial(material);
+
+				// Levels are not recorded, they are found again next to the mesh
+				mesh_renderer.lods = LoadMeshLods(mesh);
+			}
+		} break;
+		case SectionType::Camera:
+		{
+			for (uint32_t i = 0; i < section->count; i++)
+			{
+				const CameraRecord& record = view.At<CameraRecord>(i);
+
+				// The camera is created by the camera subsystem
+				CameraComponent& camera = registry.emplace<CameraComponent>(ids[view.indices[i]]);
+				camera.active = record.active != 0;
+				if (camera.camera)
+				{
+					camera.camera->SetType(static_cast<yoyo::CameraType>(record.type));
+				}
+			}
+		} break;
+		case SectionType::DirectionalLight:
+		{
+			for (uint32_t i = 0; i < section->count; i++)
+			{
+				const DirectionalLightRecord& record = view.At<DirectionalLightRecord>(i);
+
+				// The light is created by the directional light subsystem
+				DirectionalLightComponent& light = registry.emplace<DirectionalLightComponent>(ids[view.indices[i]]);
+				if (light.dir_light)
+				{
+					light.dir_light->color = { record.color[0], record.color[1], record.color[2], record.color[3] };
+					light.dir_light->direction = { record.direction[0], record.direction[1], record.direction[2], record.direction[3] };
+				}
+			}
+		} break;
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool SceneSnapshot::Save(Scene* scene, const std::string& path)
+{
+	std::vector<uint8_t> data;
+	Write(scene, data);
+
+	std::error_code error;
+	const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+	if (!directory.empty())
+	{
+		std::filesystem::create_directories(directory, error);
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		YERROR("Failed to open %s for writing!", path.c_str());
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return static_cast<bool>(file);
+}
+
+// Read only view of a whole file, unmapped when destroyed
+class MappedFile
+{
+public:
+	MappedFile(const std::string& path)
+	{
+#ifdef _WIN32
+		m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+		{
+			return;
+		}
+
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mapping)
+		{
+			return;
+		}
+
+		m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		m_size = m_data ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+		m_fd = open(path.c_str(), O_RDONLY);
+		if (m_fd < 0)
+		{
+			return;
+		}
+
+		struct stat info = {};
+		if (fstat(m_fd, &info) != 0 || info.st_size == 0)
+		{
+			return;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+		if (data == MAP_FAILED)
+		{
+			return;
+		}
+
+		m_data = static_cast<const uint8_t*>(data);
+		m_size = static_cast<size_t>(info.st_size);
+#endif
+	}
+
+	~MappedFile()
+	{
+#ifdef _WIN32
+		if (m_data) UnmapViewOfFile(m_data);
+		if (m_mapping) CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+		if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+		if (m_fd >= 0) close(m_fd);
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const uint8_t* Data() const { return m_data; }
+	size_t Size() const { return m_size; }
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+
+#ifdef _WIN32
+	HANDLE m_file = INVALID_HANDLE_VALUE;
+	HANDLE m_mapping = nullptr;
+#else
+	int m_fd = -1;
+#endif
+};
+
+bool SceneSnapshot::Load(Scene* scene, const std::string& path)
+{
+	MappedFile file(path);
+	if (!file.Data())
+	{
+		return false;
+	}
+
+	return Read(scene, file.Data(), file.Size());
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Scene;
+
+// Versioned binary image of a scene's hierarchy and component storages.
+//
+// Layout, every block 4 byte aligned:
+//  header
+//  entity records, parents come before their children
+//  string table, offsets followed by null terminated strings (tags and asset names)
+//  one section per component type, entity indices followed by fixed size records
+//
+// Assets held by components through Ref<> are written by name and resolved through the ResourceManager on load,
+// so the assets must be loaded or registered before the snapshot. Components without a section, scripts included, are not written.
+namespace SceneSnapshot
+{
+    static const uint32_t MAGIC = 0x50414E53; // "SNAP"
+    static const uint32_t VERSION = 1;
+
+    // Serializes every entity under the scene root
+    void Write(Scene* scene, std::vector<uint8_t>& out);
+
+    // Instantiates the snapshot's entities under the scene root, returns false if the data is not a valid snapshot of this version
+    bool Read(Scene* scene, const uint8_t* data, size_t size);
+
+    bool Save(Scene* scene, const std::string& path);
+
+    // Maps the file and reads it in place
+    bool Load(Scene* scene, const std::string& path);
+}
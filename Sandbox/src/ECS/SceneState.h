@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <vector>
+
+// Component and system state captured by Scene::Snapshot and written back by Scene::Restore.
+// Every kind of record has its own buffer, buffers keep their capacity so capturing into a reused state does not allocate.
+class SceneState
+{
+public:
+    SceneState() = default;
+    ~SceneState() = default;
+
+    SceneState(const SceneState&) = delete;
+    SceneState& operator=(const SceneState&) = delete;
+
+    // Returns the buffer of Record, created on first use
+    template<typename Record>
+    std::vector<Record>& Records()
+    {
+        for (const std::unique_ptr<IBuffer>& buffer : m_buffers)
+        {
+            if (buffer->type == typeid(Record))
+            {
+                return static_cast<Buffer<Record>*>(buffer.get())->records;
+            }
+        }
+
+        m_buffers.push_back(std::make_unique<Buffer<Record>>());
+        return static_cast<Buffer<Record>*>(m_buffers.back().get())->records;
+    }
+
+    // Returns the buffer of Record, null if none was captured
+    template<typename Record>
+    const std::vector<Record>* Find() const
+    {
+        for (const std::unique_ptr<IBuffer>& buffer : m_buffers)
+        {
+            if (buffer->type == typeid(Record))
+            {
+                return &static_cast<const Buffer<Record>*>(buffer.get())->records;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Empties every buffer and keeps their capacity
+    void Clear()
+    {
+        for (const std::unique_ptr<IBuffer>& buffer : m_buffers)
+        {
+            buffer->Clear();
+        }
+    }
+
+    // Id of the scene the state was captured from, 0 before the first snapshot
+    uint64_t SceneId() const { return m_scene_id; }
+private:
+    friend class Scene;
+
+    struct IBuffer
+    {
+        IBuffer(std::type_index type)
+            :type(type) {}
+        virtual ~IBuffer() = default;
+
+        virtual void Clear() = 0;
+
+        std::type_index type;
+    };
+
+    template<typename Record>
+    struct Buffer : public IBuffer
+    {
+        Buffer()
+            :IBuffer(typeid(Record)) {}
+
+        virtual void Clear() override { records.clear(); }
+
+        std::vector<Record> records;
+    };
+
+    std::vector<std::unique_ptr<IBuffer>> m_buffers;
+    uint64_t m_scene_id = 0;
+};
@@ -4,12 +4,20 @@
 #include <Core/Memory.h>
 #include <Core/Assert.h>
 
+#include "Jobs/TaskGraph.h"
+
 class ISystem
 {
 public:
     virtual void OnInit() {};
     virtual void OnUpdate(float dt) {};
     virtual void OnShutdown() {};
+
+    // Delivers batched component lifecycle changes, called by the parent system before any update
+    virtual void FlushLifecycle() {};
+
+    // Components read and written by Update, including subsystems. Systems that do not conflict may update concurrently.
+    virtual TaskAccess Access() const { return TaskAccess::Exclusive(); }
 };
 
 // Systems operate on a scene of component type T
@@ -37,6 +45,12 @@ public:
 
     void Update(float dt)
     {
+        for(auto& system : m_subsystems)
+        {
+            system->FlushLifecycle();
+        }
+        FlushLifecycle();
+
         for(auto& system : m_subsystems)
         {
             system->OnUpdate(dt);
@@ -44,6 +58,31 @@ public:
         OnUpdate(dt);
     }
 
+    virtual void FlushLifecycle() override
+    {
+        if (!m_batched)
+        {
+            return;
+        }
+
+        // Skip components destroyed, or removed and added again, since they were created
+        m_lifecycle_batch.clear();
+        for (entt::entity entity : m_created)
+        {
+            if (m_scene->Registry().valid(entity) && State(entity) == LifecycleState::CreatePending)
+            {
+                State(entity) = LifecycleState::None;
+                m_lifecycle_batch.push_back(entity);
+            }
+        }
+        m_created.clear();
+
+        if (!m_lifecycle_batch.empty())
+        {
+            OnComponentsCreated(m_lifecycle_batch);
+        }
+    }
+
     void Shutdown()
     {
         for(auto& system : m_subsystems)
@@ -55,6 +94,11 @@ public:
         YASSERT(m_scene, "System shutdown failure. Null Scene!");
         m_scene->Registry().on_construct<T>().disconnect<&System::TCreated>(this);
         m_scene->Registry().on_destroy<T>().disconnect<&System::TDestroyed>(this);
+
+        if (m_batched)
+        {
+            m_scene->OnDestroyBatch().disconnect<&System::TDestroyBatch>(this);
+        }
     };
 protected:
     Scene* GetScene() { YASSERT(m_scene, "System has invalid scene!"); return m_scene; } // Get the scene this sytem operates on
@@ -68,22 +112,108 @@ protected:
 
     // Used in the editor layer to draw the componet in the inspector.
     virtual void InspectorPanelDraw(T* component) {};
+protected:
+    // Batched systems receive components created since the last update in one OnComponentsCreated call,
+    // and the components of a scene destruction batch in one OnComponentsDestroyed call before they are destroyed.
+    // OnComponentCreated is not called, OnComponentDestroyed only for components removed outside a destruction batch.
+    void EnableBatchedLifecycle()
+    {
+        if (!m_batched)
+        {
+            m_batched = true;
+            m_scene->OnDestroyBatch().connect<&System::TDestroyBatch>(this);
+        }
+    }
+
+    virtual void OnComponentsCreated(const std::vector<entt::entity>& entities) {};
+    virtual void OnComponentsDestroyed(const std::vector<entt::entity>& entities) {};
+
+    // True while a created component waits for the next OnComponentsCreated
+    bool IsCreationPending(entt::entity entity) const
+    {
+        uint32_t index = static_cast<uint32_t>(entt::to_entity(entity));
+        return index < m_lifecycle_states.size() && m_lifecycle_states[index] == LifecycleState::CreatePending;
+    }
 private:
-    void TCreated(entt::basic_registry<entt::entity>&, entt::entity entity)
+    enum class LifecycleState : uint8_t
     {
-        Entity e(entity, m_scene);
+        None,
+        CreatePending,
+        DestroyBatched, // Delivered with its destruction batch
+    };
+
+    LifecycleState& State(entt::entity entity)
+    {
+        uint32_t index = static_cast<uint32_t>(entt::to_entity(entity));
+        if (index >= m_lifecycle_states.size())
+        {
+            m_lifecycle_states.resize(index + 1, LifecycleState::None);
+        }
 
-        T& component = e.GetComponent<T>();
-        OnComponentCreated(e, &component);
+        return m_lifecycle_states[index];
+    }
+
+    void TCreated(entt::basic_registry<entt::entity>& registry, entt::entity entity)
+    {
+        if (m_batched)
+        {
+            State(entity) = LifecycleState::CreatePending;
+            m_created.push_back(entity);
+            return;
+        }
+
+        Entity e(entity, m_scene);
+        OnComponentCreated(e, &registry.get<T>(entity));
     }
 
-    void TDestroyed(entt::basic_registry<entt::entity>&, entt::entity entity)
+    void TDestroyed(entt::basic_registry<entt::entity>& registry, entt::entity entity)
     {
+        if (m_batched)
+        {
+            // Never delivered or already delivered with its batch
+            LifecycleState& state = State(entity);
+            if (state != LifecycleState::None)
+            {
+                state = LifecycleState::None;
+                return;
+            }
+        }
+
         Entity e(entity, m_scene);
-        T& component = e.GetComponent<T>();
-        OnComponentDestroyed(e, &component);
+        OnComponentDestroyed(e, &registry.get<T>(entity));
+    }
+
+    void TDestroyBatch(const std::vector<entt::entity>& entities)
+    {
+        m_lifecycle_batch.clear();
+        for (entt::entity entity : entities)
+        {
+            if (!m_scene->Registry().all_of<T>(entity))
+            {
+                continue;
+            }
+
+            LifecycleState& state = State(entity);
+            if (state == LifecycleState::None)
+            {
+                m_lifecycle_batch.push_back(entity);
+            }
+            state = LifecycleState::DestroyBatched;
+        }
+
+        if (!m_lifecycle_batch.empty())
+        {
+            OnComponentsDestroyed(m_lifecycle_batch);
+        }
     }
 private:
     std::vector<Ref<ISystem>> m_subsystems;
     Scene* m_scene;
+
+    bool m_batched = false;
+    std::vector<entt::entity> m_created;
+    std::vector<entt::entity> m_lifecycle_batch;
+
+    // Indexed by entity index
+    std::vector<LifecycleState> m_lifecycle_states;
 };
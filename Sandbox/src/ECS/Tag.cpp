@@ -0,0 +1,56 @@
+#include "Tag.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+// Strings are never released, deque keeps them at stable addresses
+struct TagPool
+{
+	std::mutex mutex;
+	std::deque<std::string> strings;
+	std::unordered_map<std::string_view, const std::string*> lookup;
+};
+
+static TagPool& GetTagPool()
+{
+	static TagPool pool;
+	return pool;
+}
+
+static const std::string* Intern(std::string_view str)
+{
+	if (str.empty())
+	{
+		return nullptr;
+	}
+
+	TagPool& pool = GetTagPool();
+	std::lock_guard<std::mutex> lock(pool.mutex);
+
+	auto it = pool.lookup.find(str);
+	if (it != pool.lookup.end())
+	{
+		return it->second;
+	}
+
+	const std::string* interned = &pool.strings.emplace_back(str);
+	pool.lookup.emplace(*interned, interned);
+
+	return interned;
+}
+
+Tag::Tag(const char* str)
+	:m_str(Intern(str ? std::string_view(str) : std::string_view())) {}
+
+Tag::Tag(const std::string& str)
+	:m_str(Intern(str)) {}
+
+Tag::Tag(std::string_view str)
+	:m_str(Intern(str)) {}
+
+const std::string& Tag::Str() const
+{
+	static const std::string empty;
+	return m_str ? *m_str : empty;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Interned name, tags with equal strings share one pooled string and compare by pointer.
+// Interning locks the global pool, cache tags used on hot paths.
+class Tag
+{
+public:
+    Tag() = default;
+    Tag(const char* str);
+    Tag(const std::string& str);
+    Tag(std::string_view str);
+
+    const std::string& Str() const;
+    const char* CStr() const { return Str().c_str(); }
+
+    bool Empty() const { return m_str == nullptr; }
+
+    bool operator==(const Tag& other) const { return m_str == other.m_str; }
+    bool operator!=(const Tag& other) const { return m_str != other.m_str; }
+private:
+    friend struct std::hash<Tag>;
+
+    // Null for the empty tag
+    const std::string* m_str = nullptr;
+};
+
+template<>
+struct std::hash<Tag>
+{
+    size_t operator()(const Tag& tag) const { return std::hash<const std::string*>()(tag.m_str); }
+};
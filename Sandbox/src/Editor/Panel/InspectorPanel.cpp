@@ -68,7 +68,7 @@ void InspectorPanel::Draw(Scene* scene)
 	if (Entity e = m_focused_entity)
 	{
 		const TagComponent& tag = e.GetComponent<TagComponent>();
-		ImGui::Text("%s [%d]", tag.tag.c_str(), e.Id());
+		ImGui::Text("%s [%d]", tag.tag.CStr(), e.Id());
 
 		ImGui::Separator();
 
@@ -209,7 +209,10 @@ void InspectorPanel::DrawComponents()
 
 		ImGui::TableSetColumnIndex(1);
 		ImGui::PushItemWidth(label_width * 3.0f);
-		ImGui::DragFloat3("##Position", transform.position.elements);
+		if (ImGui::DragFloat3("##Position", transform.position.elements))
+		{
+			transform.MarkDirty();
+		}
 		ImGui::PopItemWidth();
 
 		ImGui::TableNextRow();
@@ -223,9 +226,9 @@ void InspectorPanel::DrawComponents()
 		yoyo::Vec3 degrees = { yoyo::RadToDeg(transform.rotation.x), yoyo::RadToDeg(transform.rotation.y), yoyo::RadToDeg(transform.rotation.z) };
 		if (ImGui::DragFloat3("##Rotation", degrees.elements))
 		{
-			transform.quat_rotation = yoyo::QuatFromAxisAngle({ 1.0f, 0.0f, 0.0f }, yoyo::DegToRad(degrees.x))
+			transform.SetRotation(yoyo::QuatFromAxisAngle({ 1.0f, 0.0f, 0.0f }, yoyo::DegToRad(degrees.x))
 				* yoyo::QuatFromAxisAngle({ 0.0f, 1.0f, 0.0f }, yoyo::DegToRad(degrees.y))
-				* yoyo::QuatFromAxisAngle({ 0.0f, 0.0f, 1.0f }, yoyo::DegToRad(degrees.z));
+				* yoyo::QuatFromAxisAngle({ 0.0f, 0.0f, 1.0f }, yoyo::DegToRad(degrees.z)));
 		}
 
 		ImGui::PopItemWidth();
@@ -237,7 +240,10 @@ void InspectorPanel::DrawComponents()
 
 		ImGui::TableSetColumnIndex(1);
 		ImGui::PushItemWidth(label_width * 3.0f);
-		ImGui::DragFloat3("##Scale", transform.scale.elements);
+		if (ImGui::DragFloat3("##Scale", transform.scale.elements))
+		{
+			transform.MarkDirty();
+		}
 		ImGui::PopItemWidth();
 
 		ImGui::EndTable();
@@ -361,7 +367,7 @@ void InspectorPanel::DrawComponents()
 		}, false);
 
 	DrawComponentUI<AnimatorComponent>("Animator", m_focused_entity, [](AnimatorComponent& animator_component) {
-		Ref<yoyo::Animator> animator = animator_component.animator;
+		yoyo::Animator* animator = animator_component.animator.Get();
 
 		if (!animator)
 		{
@@ -73,14 +73,10 @@ void SceneHierarchyPanel::DrawNodeRecursive(Entity node, bool open)
 	const TransformComponent& node_transform = node.GetComponent<TransformComponent>();
 	const TagComponent& node_tag = node.GetComponent<TagComponent>();
 
-	std::string node_name = node_tag.tag;
-
-	if(node_transform.children_count > 0)
-	{
-		node_name += " (" + std::to_string(node_transform.children_count) + ")";
-	}
-
-	bool node_open = ImGui::TreeNodeEx((void*)(intptr_t)(node.Id()), node_flags, "%s", node_name.c_str());
+	// Formatted by ImGui, tags are not copied
+	bool node_open = node_transform.children_count > 0 ?
+		ImGui::TreeNodeEx((void*)(intptr_t)(node.Id()), node_flags, "%s (%u)", node_tag.tag.CStr(), node_transform.children_count) :
+		ImGui::TreeNodeEx((void*)(intptr_t)(node.Id()), node_flags, "%s", node_tag.tag.CStr());
 
 	if (ImGui::IsItemClicked())
 	{
@@ -90,10 +86,9 @@ void SceneHierarchyPanel::DrawNodeRecursive(Entity node, bool open)
 
 	if (node_open)
 	{
-		for (uint32_t i = 0; i < node_transform.children_count; i++)
+		for (Entity child = node_transform.first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
 		{
-			Entity e = node_transform.children[i];
-			DrawNodeRecursive(node_transform.children[i]);
+			DrawNodeRecursive(child);
 		}
 
 		ImGui::TreePop();
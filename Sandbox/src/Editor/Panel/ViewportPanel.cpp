@@ -42,9 +42,9 @@ void ViewportPanel::Draw(Scene* scene)
 	ImGui::Image(m_renderer->GetViewPortTexture(), viewport_size);
 
 	// Gizmos
-	if (Entity camera = scene->FindEntityWithComponent<CameraComponent>())
+	if (Entity camera = scene->Singleton<CameraComponent>())
 	{
-		Ref<yoyo::Camera> cam = camera.GetComponent<CameraComponent>().camera;
+		yoyo::Camera* cam = camera.GetComponent<CameraComponent>().camera.Get();
 		if (m_focused_entity)
 		{
 			if(cam->GetType() == yoyo::CameraType::Orthographic)
@@ -112,9 +112,9 @@ void ViewportPanel::Draw(Scene* scene)
 
 			if (ImGuizmo::IsUsing())
 			{
-				transform.position = translation;
-				//transform.scale = scale;
-				transform.quat_rotation = quat_rotation;
+				transform.SetPosition(translation);
+				//transform.SetScale(scale);
+				transform.SetRotation(quat_rotation);
 			}
 		}
 	}
@@ -0,0 +1,229 @@
+#include "GameLevel.h"
+
+#include <Math/Math.h>
+#include <Math/MatrixTransform.h>
+#include <Math/Quaternion.h>
+
+#include <Core/Memory.h>
+#include <Resource/ResourceManager.h>
+
+#include <Renderer/Texture.h>
+#include <Renderer/Shader.h>
+#include <Renderer/Material.h>
+#include <Renderer/Camera.h>
+#include <Renderer/Light.h>
+
+#include "ECS/Scene.h"
+#include "ECS/SceneSnapshot.h"
+#include "ECS/Components/Components.h"
+#include "ECS/Components/RenderableComponents.h"
+
+#include "Scripts/CameraController.h"
+#include "Scripts/Sun.h"
+
+void LoadGameAssets()
+{
+    Ref<yoyo::Shader> default_lit = yoyo::ResourceManager::Instance().Load<yoyo::Shader>("lit_shader");
+    Ref<yoyo::Shader> default_lit_instanced = yoyo::ResourceManager::Instance().Load<yoyo::Shader>("lit_instanced_shader");
+    Ref<yoyo::Shader> skinned_lit = yoyo::ResourceManager::Instance().Load<yoyo::Shader>("skinned_lit_shader");
+
+    Ref<yoyo::Material> default_material = yoyo::Material::Create(default_lit, "default_material");
+    Ref<yoyo::Texture> default_texture = yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/prototype_512x512_white.yo");
+    default_material->SetTexture(yoyo::MaterialTextureType::MainTexture, default_texture);
+    default_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+    default_material->SetVec4("specular_color", yoyo::Vec4{ 1.0, 1.0f, 1.0f, 1.0f });
+    default_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+
+    Ref<yoyo::Material> default_instanced_material = yoyo::Material::Create(default_lit_instanced, "default_instanced_material");
+    Ref<yoyo::Texture> default_instanced_texture = yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/prototype_512x512_white.yo");
+    default_instanced_material->SetTexture(yoyo::MaterialTextureType::MainTexture, default_instanced_texture);
+    default_instanced_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+    default_instanced_material->SetVec4("specular_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+    default_instanced_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+
+    yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/plane.yo");
+    Ref<yoyo::Model> cube_model = yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/cube.yo");
+
+    // Universal game material
+    {
+        Ref<yoyo::Material> people_material = yoyo::Material::Create(default_lit_instanced, "people_material");
+        people_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/people_texture_map.yo"));
+        people_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        people_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        people_material->SetVec4("specular_color", yoyo::Vec4{ 1.0, 1.0f, 1.0f, 1.0f });
+
+        Ref<yoyo::Material> colormap_material = yoyo::Material::Create(default_lit_instanced, "colormap_material");
+        colormap_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/colormap.yo"));
+        colormap_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        colormap_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        colormap_material->SetVec4("specular_color", yoyo::Vec4{ 1.0, 1.0f, 1.0f, 1.0f });
+
+        Ref<yoyo::Material> grenade_instanced_material = yoyo::Material::Create(default_lit_instanced, "grenade_instanced_material");
+        Ref<yoyo::Texture> grenade_instanced_texture = yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/prototype_512x512_white.yo");
+        grenade_instanced_material->SetTexture(yoyo::MaterialTextureType::MainTexture, grenade_instanced_texture);
+        grenade_instanced_material->SetVec4("diffuse_color", yoyo::Vec4{ 0.0f, 1.0f, 0.0f, 1.0f });
+        grenade_instanced_material->SetVec4("specular_color", yoyo::Vec4{ 0.25, 0.0f, 0.0f, 1.0f });
+        grenade_instanced_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+    }
+
+    // Animated Universal
+    {
+        Ref<yoyo::Material> skinned_default_material = yoyo::Material::Create(skinned_lit, "skinned_default_material");
+        skinned_default_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/prototype_512x512_white.yo"));
+        skinned_default_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        skinned_default_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        skinned_default_material->SetVec4("specular_color", yoyo::Vec4{ 1.0, 1.0f, 1.0f, 1.0f });
+
+        Ref<yoyo::Material> skinned_people_material = yoyo::Material::Create(skinned_lit, "skinned_people_material");
+        skinned_people_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/people_texture_map.yo"));
+        skinned_people_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        skinned_people_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        skinned_people_material->SetVec4("specular_color", yoyo::Vec4{ 0.0f, 0.0f, 0.0f, 0.0f });
+
+        Ref<yoyo::Material> skinned_damaged_material = yoyo::Material::Create(skinned_lit, "skinned_damaged_material");
+        skinned_damaged_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/people_texture_map.yo"));
+        skinned_damaged_material->SetColor(yoyo::Vec4{ 1.0f, 0.0f, 0.0f, 1.0f });
+        skinned_damaged_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 0.0f, 0.0f, 1.0f });
+        skinned_damaged_material->SetVec4("specular_color", yoyo::Vec4{ 0.0f, 0.0f, 0.0f, 0.0f });
+#ifdef Y_DEBUG
+        {
+            Ref<yoyo::Shader> skinned_lit_debug = yoyo::ResourceManager::Instance().Load<yoyo::Shader>("skinned_lit_debug_shader");
+
+            Ref<yoyo::Material> color_map_skinned_material = yoyo::Material::Create(skinned_lit_debug, "skinned_colormap_debug_material");
+            color_map_skinned_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/colormap.yo"));
+            color_map_skinned_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+            color_map_skinned_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+            color_map_skinned_material->SetVec4("specular_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+
+            uint32_t index = 0;
+            color_map_skinned_material->SetProperty("focused_bone_index", &index);
+        }
+
+        {
+            Ref<yoyo::Shader> collider_debug = yoyo::ResourceManager::Instance().Load<yoyo::Shader>("unlit_collider_debug_shader");
+            Ref<yoyo::Material> collider_debug_material = yoyo::Material::Create(collider_debug, "collider_debug_material");
+
+            collider_debug_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/prototype_512x512_white.yo"));
+            collider_debug_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+            collider_debug_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+            collider_debug_material->SetVec4("specular_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        }
+#endif
+    }
+
+    // Animated Mutant
+    {
+        Ref<yoyo::Material> skinned_mutant_material = yoyo::Material::Create(skinned_lit, "skinned_mutant_material");
+        skinned_mutant_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/Mutant_diffuse.yo"));
+        skinned_mutant_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        skinned_mutant_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        skinned_mutant_material->SetVec4("specular_color", yoyo::Vec4{ 0.0, 0.0f, 0.0f, 0.0f });
+    }
+
+    // Lights
+    {
+        Ref<yoyo::Material> light_material = yoyo::Material::Create(default_lit, "light_material");
+        //light_material->ToggleReceiveShadows(false);
+        light_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/prototype_512x512_white.yo"));
+
+        // TODO: Apply material color
+        light_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 0.0f, 1.0f });
+        light_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 0.0f, 1.0f });
+        light_material->SetVec4("specular_color", yoyo::Vec4{ 1.0, 1.0f, 1.0f, 1.0f });
+    }
+
+    // Floors
+    {
+        Ref<yoyo::Material> grid_material = yoyo::Material::Create(default_lit_instanced, "grid_material");
+        Ref<yoyo::Texture> grid_texture = yoyo::ResourceManager::Instance().Load<yoyo::Texture>("assets/textures/prototype_512x512_white.yo");
+        grid_texture->SetSamplerType(yoyo::TextureSamplerType::Linear);
+        grid_material->SetTexture(yoyo::MaterialTextureType::MainTexture, grid_texture);
+        grid_material->SetColor(yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        grid_material->SetVec4("diffuse_color", yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f });
+        grid_material->SetVec4("specular_color", yoyo::Vec4{ 0.0, 0.0f, 0.0f, 0.0f });
+    }
+}
+
+// Scripts are not part of the snapshot
+static void AttachLevelScripts(Scene* scene)
+{
+    Entity light = scene->FindEntityWithTag("light");
+    light.AddComponent<SunComponent>(light);
+
+    Entity camera = scene->FindEntityWithTag("camera");
+    camera.AddComponent<CameraControllerComponent>(camera);
+}
+
+static void BuildLevelEntities(Scene* scene)
+{
+    // Lights
+    {
+        Entity light = scene->Instantiate("light", { 100.0f, 60.0f, 5.0f });
+        Ref<yoyo::DirectionalLight> dir_light = light.AddComponent<DirectionalLightComponent>().dir_light;
+        dir_light->color = { 1.0f, 1.0f, 1.0f, 1.0f };
+        dir_light->direction = yoyo::Vec4{ 1.0f, 1.0f, 1.0f, 1.0f } *-1.0f;
+
+        auto& mesh_renderer = light.AddComponent<MeshRendererComponent>();
+        mesh_renderer.SetMesh(yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>("Cube"));
+        mesh_renderer.SetMaterial(yoyo::ResourceManager::Instance().Load<yoyo::Material>("light_material"));
+    }
+
+    // Set up scene
+    auto camera = scene->Instantiate("camera", { 0.0f, 50.0f, 50.0f });
+    // camera.AddComponent<CameraComponent>().camera->SetType(yoyo::CameraType::Orthographic);
+    camera.AddComponent<CameraComponent>().camera->SetType(yoyo::CameraType::Perspective);
+
+    // Plane
+    if(true){
+        Ref<yoyo::Material> grid_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("grid_material");
+
+        Entity floors = scene->Instantiate("floors", { 0.0f, 0.0f, 0.0f });
+
+        float root = 5;
+        float dim = 16.0f;
+        for (int j = -root; j < root; j++)
+        {
+            for (int i = -root; i < root; i++)
+            {
+                auto plane = scene->Instantiate("plane", { dim * 2.0f * i, 0.0f, dim * 2.0f * j });
+
+                TransformComponent& transform = plane.GetComponent<TransformComponent>();
+                transform.SetScale({ dim, dim, 1.0f });
+                transform.SetRotation(yoyo::QuatFromAxisAngle({ 1, 0, 0 }, yoyo::DegToRad(-90)));
+
+                MeshRendererComponent& mesh_renderer = plane.AddComponent<MeshRendererComponent>();
+                mesh_renderer.SetMesh(yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>("Plane"));
+                mesh_renderer.SetMaterial(grid_material);
+
+                floors.GetComponent<TransformComponent>().AddChild(plane);
+            }
+        }
+    }
+}
+
+void BuildGameLevel(Scene* scene)
+{
+    BuildLevelEntities(scene);
+    AttachLevelScripts(scene);
+}
+
+bool LoadGameLevel(Scene* scene, const std::string& snapshot_path)
+{
+    if (SceneSnapshot::Load(scene, snapshot_path))
+    {
+        AttachLevelScripts(scene);
+        return true;
+    }
+
+    BuildGameLevel(scene);
+    return false;
+}
+
+bool WriteGameLevelSnapshot(Scene* scene, const std::string& snapshot_path)
+{
+    BuildLevelEntities(scene);
+    bool saved = SceneSnapshot::Save(scene, snapshot_path);
+
+    AttachLevelScripts(scene);
+    return saved;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+
+class Scene;
+
+// Creates the shaders, textures and named materials used by the game scripts
+void LoadGameAssets();
+
+// Populates the scene with the level's light, camera and floor grid
+void BuildGameLevel(Scene* scene);
+
+// Reads the level from its snapshot, or builds it when the file is missing or from another version. Returns true if the level was read from the snapshot.
+// The snapshot is never written here, it is baked explicitly with WriteGameLevelSnapshot (CapitalPunishmentBench --write-level-snapshot) and must be
+// baked again after changing BuildGameLevel or the assets it references. Assets must be loaded first.
+bool LoadGameLevel(Scene* scene, const std::string& snapshot_path = "assets/scenes/game_level.snapshot");
+
+// Builds the level into the scene and writes its snapshot, returns false if the file could not be written
+bool WriteGameLevelSnapshot(Scene* scene, const std::string& snapshot_path = "assets/scenes/game_level.snapshot");
@@ -0,0 +1,50 @@
+#include "GameTasks.h"
+
+#include <Renderer/Animation.h>
+
+#include "ECS/Scene.h"
+#include "ECS/Components/Components.h"
+#include "ECS/Components/RenderableComponents.h"
+
+#include "Jobs/TaskGraph.h"
+
+#include "SceneGraph/SceneGraph.h"
+#include "Physics/Physics3D.h"
+#include "Scripts/NativeScript.h"
+#include "ParticleSystem/Particles.h"
+#include "RenderScene/RenderScene.h"
+
+void BuildGameTaskGraph(TaskGraph& graph, const GameSystems& systems)
+{
+    Scene* scene = systems.scene;
+
+    graph.AddTask("Game [PhysicsWorld]", systems.physics_world->Access(), [=](float dt) {
+        systems.physics_world->Update(dt);
+    });
+
+    graph.AddTask("Game [Scene Graph]", systems.scene_graph->Access(), [=](float dt) {
+        systems.scene_graph->Update(dt);
+    });
+
+    // Animation System
+    scene->Pack<TransformComponent, AnimatorComponent>();
+    graph.AddTask("Game [Animation]", TaskAccess().Read<TransformComponent>().Write<AnimatorComponent>(), [=](float dt) {
+        scene->Each<TransformComponent, AnimatorComponent>([dt](const TransformComponent&, AnimatorComponent& animator) {
+            animator.animator->Update(dt);
+        });
+    });
+
+    // Structural changes recorded by scripts and physics callbacks are applied after scripting
+    graph.AddTask("Game [Scripting]", systems.scripting->Access(), [=](float dt) {
+        systems.scripting->Update(dt);
+        scene->FlushCommandBuffers();
+    });
+
+    graph.AddTask("Game [Particles]", systems.particles->Access(), [=](float dt) {
+        systems.particles->Update(dt);
+    });
+
+    graph.AddTask("Game [Render Scene]", systems.render_scene->Access(), [=](float dt) {
+        systems.render_scene->Update(dt);
+    });
+}
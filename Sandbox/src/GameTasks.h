@@ -0,0 +1,28 @@
+#pragma once
+
+class Scene;
+class SceneGraph;
+class ScriptingSystem;
+class ParticleSystemManager;
+class RenderSceneSystem;
+class TaskGraph;
+
+namespace psx
+{
+    class PhysicsWorld;
+}
+
+// Systems updated by the game every frame
+struct GameSystems
+{
+    Scene* scene = nullptr;
+
+    SceneGraph* scene_graph = nullptr;
+    psx::PhysicsWorld* physics_world = nullptr;
+    ScriptingSystem* scripting = nullptr;
+    ParticleSystemManager* particles = nullptr;
+    RenderSceneSystem* render_scene = nullptr;
+};
+
+// Adds the per frame game update to the graph, tasks are named after their profile keys
+void BuildGameTaskGraph(TaskGraph& graph, const GameSystems& systems);
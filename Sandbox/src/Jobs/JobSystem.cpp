@@ -0,0 +1,120 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <memory>
+
+JobSystem& JobSystem::Instance()
+{
+	// Leave a core for the main thread
+	static JobSystem job_system(std::max(1u, std::thread::hardware_concurrency()) - 1);
+	return job_system;
+}
+
+JobSystem::JobSystem(uint32_t worker_count)
+{
+	m_workers.reserve(worker_count);
+	for (uint32_t i = 0; i < worker_count; i++)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running = false;
+	}
+	m_job_available.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::Submit(Job job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(std::move(job));
+	}
+	m_job_available.notify_one();
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t min_batch_size, const RangeJob& job)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	min_batch_size = std::max(1u, min_batch_size);
+	uint32_t batch_count = (count + min_batch_size - 1) / min_batch_size;
+	uint32_t helper_count = std::min(batch_count - 1, WorkerCount());
+
+	if (helper_count == 0)
+	{
+		job(0, count);
+		return;
+	}
+
+	// Shared with helpers that may only get scheduled after the caller is done
+	struct Batches
+	{
+		std::atomic<uint32_t> next{ 0 };
+		std::atomic<uint32_t> remaining{ 0 };
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+
+	auto batches = std::make_shared<Batches>();
+	batches->remaining = batch_count;
+
+	auto run_batches = [batches, batch_count, count, min_batch_size, &job]()
+	{
+		uint32_t batch;
+		while ((batch = batches->next.fetch_add(1)) < batch_count)
+		{
+			uint32_t begin = batch * min_batch_size;
+			job(begin, std::min(begin + min_batch_size, count));
+
+			if (batches->remaining.fetch_sub(1) == 1)
+			{
+				std::lock_guard<std::mutex> lock(batches->mutex);
+				batches->done.notify_all();
+			}
+		}
+	};
+
+	for (uint32_t i = 0; i < helper_count; i++)
+	{
+		Submit(run_batches);
+	}
+	run_batches();
+
+	std::unique_lock<std::mutex> lock(batches->mutex);
+	batches->done.wait(lock, [&]() { return batches->remaining == 0; });
+}
+
+void JobSystem::WorkerLoop()
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_job_available.wait(lock, [this]() { return !m_jobs.empty() || !m_running; });
+
+			if (!m_running && m_jobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		job();
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads shared by the game systems
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+    static JobSystem& Instance();
+
+    explicit JobSystem(uint32_t worker_count);
+    ~JobSystem();
+
+    // Queues a job to run on a worker thread
+    void Submit(Job job);
+
+    // Splits [0, count) into batches of at least min_batch_size and blocks until all batches have run.
+    // The calling thread works on batches as well.
+    void ParallelFor(uint32_t count, uint32_t min_batch_size, const RangeJob& job);
+
+    uint32_t WorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+private:
+    void WorkerLoop();
+private:
+    std::vector<std::thread> m_workers;
+
+    std::deque<Job> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_job_available;
+    bool m_running = true;
+};
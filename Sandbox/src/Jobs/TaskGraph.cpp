@@ -0,0 +1,204 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+
+#include <Core/Assert.h>
+#include <Core/Time.h>
+
+#include "JobSystem.h"
+
+static bool Overlaps(const std::vector<std::type_index>& a, const std::vector<std::type_index>& b)
+{
+	for (const std::type_index& type : a)
+	{
+		if (std::find(b.begin(), b.end(), type) != b.end())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TaskAccess::ConflictsWith(const TaskAccess& other) const
+{
+	if (exclusive || other.exclusive)
+	{
+		return true;
+	}
+
+	return Overlaps(writes, other.writes) || Overlaps(writes, other.reads) || Overlaps(reads, other.writes);
+}
+
+TaskGraph::~TaskGraph()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_task_ready.wait(lock, [this]() { return m_helpers == 0; });
+}
+
+void TaskGraph::AddTask(const std::string& name, const TaskAccess& access, TaskFunction function)
+{
+	uint32_t index = static_cast<uint32_t>(m_tasks.size());
+
+	Task task = {};
+	task.name = name;
+	task.access = access;
+	task.function = std::move(function);
+
+	// Depend on every earlier conflicting task, transitive edges are harmless
+	for (uint32_t i = 0; i < index; i++)
+	{
+		if (m_tasks[i].access.ConflictsWith(access))
+		{
+			m_tasks[i].dependents.push_back(index);
+			task.dependency_count++;
+		}
+	}
+
+	m_tasks.push_back(std::move(task));
+}
+
+void TaskGraph::Run(float dt)
+{
+	size_t ready_count = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_dt = dt;
+		m_completed = 0;
+		m_pending.resize(m_tasks.size());
+		for (uint32_t i = 0; i < m_tasks.size(); i++)
+		{
+			m_pending[i] = m_tasks[i].dependency_count;
+			if (m_pending[i] == 0)
+			{
+				(m_tasks[i].access.exclusive ? m_ready_exclusive : m_ready).push_back(i);
+			}
+		}
+		ready_count = m_ready.size();
+	}
+
+	// Workers pick up tasks as they become ready, the calling thread runs tasks until the graph is done.
+	// Helpers that start late find no ready tasks and return.
+	for (size_t i = 1; i < ready_count; i++)
+	{
+		SubmitHelper();
+	}
+
+	while (true)
+	{
+		uint32_t index;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_task_ready.wait(lock, [this]()
+			{
+				return !m_ready.empty() || !m_ready_exclusive.empty() || m_completed == m_tasks.size();
+			});
+
+			if (m_completed == m_tasks.size())
+			{
+				// Late helpers would otherwise pick up the next run's tasks or outlive the graph
+				m_task_ready.wait(lock, [this]() { return m_helpers == 0; });
+				break;
+			}
+		}
+
+		if (PopReadyTask(true, index))
+		{
+			RunTask(index);
+		}
+	}
+
+	YASSERT(m_ready.empty() && m_ready_exclusive.empty(), "Task graph finished with tasks left!");
+}
+
+void TaskGraph::SubmitHelper()
+{
+	// Without workers the calling thread runs every task
+	if (JobSystem::Instance().WorkerCount() == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_helpers++;
+	}
+
+	JobSystem::Instance().Submit([this]() { RunReadyTasks(); });
+}
+
+void TaskGraph::RunReadyTasks()
+{
+	uint32_t index;
+	while (PopReadyTask(false, index))
+	{
+		RunTask(index);
+	}
+
+	// Notified under the lock, the graph may be destroyed as soon as it is released
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_helpers--;
+	m_task_ready.notify_all();
+}
+
+void TaskGraph::RunTask(uint32_t index)
+{
+	Task& task = m_tasks[index];
+	{
+		yoyo::ScopedTimer timer([&](const yoyo::ScopedTimer& timer) {
+			task.time = timer.delta;
+		});
+		task.function(m_dt);
+	}
+
+	uint32_t ready_count = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (uint32_t dependent : task.dependents)
+		{
+			if (--m_pending[dependent] == 0)
+			{
+				if (m_tasks[dependent].access.exclusive)
+				{
+					m_ready_exclusive.push_back(dependent);
+				}
+				else
+				{
+					m_ready.push_back(dependent);
+					ready_count++;
+				}
+			}
+		}
+		m_completed++;
+	}
+	m_task_ready.notify_all();
+
+	// This thread keeps one of the newly ready tasks, the rest go to workers
+	for (uint32_t i = 1; i < ready_count; i++)
+	{
+		SubmitHelper();
+	}
+}
+
+bool TaskGraph::PopReadyTask(bool calling_thread, uint32_t& index)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Exclusive tasks only run on the thread that owns the scene
+	if (calling_thread && !m_ready_exclusive.empty())
+	{
+		index = m_ready_exclusive.front();
+		m_ready_exclusive.pop_front();
+		return true;
+	}
+
+	if (!m_ready.empty())
+	{
+		index = m_ready.front();
+		m_ready.pop_front();
+		return true;
+	}
+
+	return false;
+}
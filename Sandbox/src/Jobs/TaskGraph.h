@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+// Component and resource types a task reads and writes
+struct TaskAccess
+{
+    std::vector<std::type_index> reads;
+    std::vector<std::type_index> writes;
+
+    // Touches arbitrary components or creates and destroys entities, runs alone on the calling thread
+    bool exclusive = false;
+
+    template<typename... Ts>
+    TaskAccess& Read()
+    {
+        (reads.push_back(typeid(Ts)), ...);
+        return *this;
+    }
+
+    template<typename... Ts>
+    TaskAccess& Write()
+    {
+        (writes.push_back(typeid(Ts)), ...);
+        return *this;
+    }
+
+    static TaskAccess Exclusive()
+    {
+        TaskAccess access = {};
+        access.exclusive = true;
+        return access;
+    }
+
+    bool ConflictsWith(const TaskAccess& other) const;
+};
+
+// Runs tasks across the job system, each task waits only on earlier tasks it conflicts with
+class TaskGraph
+{
+public:
+    using TaskFunction = std::function<void(float dt)>;
+
+    struct Task
+    {
+        std::string name;
+        TaskAccess access;
+        TaskFunction function;
+
+        std::vector<uint32_t> dependents;
+        uint32_t dependency_count = 0;
+
+        float time = 0.0f; // Duration of the last run in seconds
+    };
+
+    TaskGraph() = default;
+    ~TaskGraph();
+
+    // Tasks are ordered by insertion where their access conflicts
+    void AddTask(const std::string& name, const TaskAccess& access, TaskFunction function);
+
+    // Runs every task once and blocks until all are done and every worker helping with them has returned
+    void Run(float dt);
+
+    const std::vector<Task>& Tasks() const { return m_tasks; }
+private:
+    // Queues a worker job that runs ready tasks, counted until it returns
+    void SubmitHelper();
+    void RunReadyTasks();
+    void RunTask(uint32_t index);
+    bool PopReadyTask(bool calling_thread, uint32_t& index);
+private:
+    std::vector<Task> m_tasks;
+
+    // Per run state
+    float m_dt = 0.0f;
+    std::vector<uint32_t> m_pending;
+    std::deque<uint32_t> m_ready;
+    std::deque<uint32_t> m_ready_exclusive;
+    uint32_t m_completed = 0;
+
+    // Helper jobs submitted and not yet returned, they touch the graph until they do
+    uint32_t m_helpers = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_ready;
+};
@@ -1,5 +1,6 @@
 #include "Particles.h"
 #include "ECS/Components/Components.h"
+#include "RenderScene/RenderPipeline.h"
 
 #include <thread>
 
@@ -11,7 +12,6 @@
 #include <Math/Random.h>
 #include <Math/MatrixTransform.h>
 
-#include <Renderer/RendererLayer.h>
 #include <Renderer/Camera.h>
 
 #include <Core/Time.h>
@@ -24,8 +24,6 @@ ParticleSystemComponent::ParticleSystemComponent()
 	}
 }
 
-ParticleSystemComponent::~ParticleSystemComponent() {}
-
 const std::vector<yoyo::Particle>& ParticleSystemComponent::GetParticles() const { return m_particle_system->GetParticles(); }
 
 const uint32_t ParticleSystemComponent::GetMaxParticles() const { return m_particle_system->GetMaxParticles(); }
@@ -147,9 +145,6 @@ void ParticleSystemComponent::AddMaterial(Ref<yoyo::Material> material) {
 
 void ParticleSystemManager::OnInit()
 {
-	m_render_packet = YNEW yoyo::RenderPacket;
-	m_render_packet->ToggleAutoReset(true);
-
 	Ref<yoyo::Shader> unlit_particle_shader = yoyo::ResourceManager::Instance().Load<yoyo::Shader>("unlit_particle_instanced_shader");
 
 	Ref<yoyo::Material> particle_instanced_material = yoyo::Material::Create(unlit_particle_shader, "default_particle_material");
@@ -172,18 +167,37 @@ void ParticleSystemManager::OnInit()
 		{{ 1.00,  1.00,  0.00}, {0.00, 0.00, 0.00},  {0.00,  0.00,  1.00},  {1.00,  1.00}},
 		{{-1.00,  1.00,  0.00}, {0.00, 0.00, 0.00},  {0.00,  0.00,  1.00},  {0.00,  1.00}},
 	};
+
+	GetScene()->OnDisableBatch().connect<&ParticleSystemManager::OnDisableBatch>(this);
+	GetScene()->OnDestroyBatch().connect<&ParticleSystemManager::OnDestroyBatch>(this);
+
+	GetScene()->Pack<TransformComponent, ParticleSystemComponent>();
+
+	// Billboards face the main camera
+	GetScene()->RegisterSingleton<CameraComponent>();
 }
 
 void ParticleSystemManager::OnShutdown()
 {
-	YDELETE m_render_packet;
+	GetScene()->OnDisableBatch().disconnect<&ParticleSystemManager::OnDisableBatch>(this);
+	GetScene()->OnDestroyBatch().disconnect<&ParticleSystemManager::OnDestroyBatch>(this);
+
+}
+
+TaskAccess ParticleSystemManager::Access() const
+{
+	// Billboards read the main camera, renderables go to the particle stream of the render pipeline
+	return TaskAccess()
+		.Read<TransformComponent, CameraComponent>()
+		.Write<ParticleSystemComponent>();
 }
 
 void ParticleSystemManager::OnUpdate(float dt)
 {
 	// Remove camera rotation for billboard particles
 	yoyo::Mat4x4  transpose_view = {};
-	if (const auto camera = m_renderer_layer->GetScene()->camera)
+	Entity camera_entity = GetScene()->Singleton<CameraComponent>();
+	if (yoyo::Camera* camera = camera_entity ? camera_entity.GetComponent<CameraComponent>().camera.Get() : nullptr)
 	{
 		transpose_view = yoyo::TransposeMat4x4(camera->View());
 
@@ -194,14 +208,37 @@ void ParticleSystemManager::OnUpdate(float dt)
 		transpose_view[15] = 1;
 	}
 
-	for (auto entity : GetScene()->Registry().group<ParticleSystemComponent>())
-	{
-		Entity e(entity, GetScene());
-		const TransformComponent& transform = e.GetComponent<TransformComponent>();
+	// Renderables are written when the frame is submitted
+	RenderStream& stream = m_pipeline->Stream(RenderStreamType::Particles);
 
-		ParticleSystemComponent& particle_system_component = e.GetComponent<ParticleSystemComponent>();
+	GetScene()->Each<TransformComponent, ParticleSystemComponent>([&](const TransformComponent& transform, ParticleSystemComponent& particle_system_component)
+	{
 		const auto& particles = particle_system_component.GetParticles();
 
+		auto update_renderable = [&](uint32_t i)
+		{
+			RenderHandle<yoyo::MeshPassObject> renderable_object = particle_system_component.m_particle_renderable_objects[i].Handle();
+			if (particle_system_component.IsBillBoard())
+			{
+				// Local
+				transpose_view[12] = transform.model_matrix.data[12];
+				transpose_view[13] = transform.model_matrix.data[13];
+				transpose_view[14] = transform.model_matrix.data[14];
+
+				yoyo::Mat4x4 model_matrix =
+					transpose_view *
+					yoyo::TranslationMat4x4(particles[i].position) *
+					yoyo::TransposeMat4x4(yoyo::QuatToMat4x4(yoyo::QuatFromAxisAngle(yoyo::Vec3{0.0f, 0.0f, 1.0f}, particles[i].rotation.z))) *
+					yoyo::ScaleMat4x4(particles[i].scale);
+				stream.transforms.push_back({ renderable_object, model_matrix });
+				stream.colors.push_back({ renderable_object, particles[i].color });
+			}
+			else
+			{
+				stream.transforms.push_back({ renderable_object, transform.model_matrix * yoyo::TranslationMat4x4(particles[i].position) });
+			}
+		};
+
 		uint32_t prev_particle_count = particle_system_component.GetParticlesAlive();
 		particle_system_component.m_particle_system->Update(dt);
 		uint32_t particle_count = particle_system_component.GetParticlesAlive();
@@ -211,64 +248,24 @@ void ParticleSystemManager::OnUpdate(float dt)
 		{
 			for (uint32_t i = prev_particle_count; i < particle_count; i++)
 			{
-				if (particle_system_component.IsBillBoard())
-				{
-					// Local
-					transpose_view[12] = transform.model_matrix.data[12];
-					transpose_view[13] = transform.model_matrix.data[13];
-					transpose_view[14] = transform.model_matrix.data[14];
-
-					auto& renderable_object = particle_system_component.m_particle_renderable_objects[i];
-					renderable_object->model_matrix =
-						transpose_view *
-						yoyo::TranslationMat4x4(particles[i].position) *
-						yoyo::TransposeMat4x4(yoyo::QuatToMat4x4(yoyo::QuatFromAxisAngle(yoyo::Vec3{0.0f, 0.0f, 1.0f}, particles[i].rotation.z))) *
-						yoyo::ScaleMat4x4(particles[i].scale);
-					renderable_object->color = particles[i].color;
-				}
-				else
-				{
-					auto& renderable_object = particle_system_component.m_particle_renderable_objects[i];
-					renderable_object->model_matrix = transform.model_matrix * yoyo::TranslationMat4x4(particles[i].position);
-				}
-				m_render_packet->new_objects.push_back(particle_system_component.m_particle_renderable_objects[i]);
+				update_renderable(i);
+				stream.packet.new_objects.push_back(particle_system_component.m_particle_renderable_objects[i].Share());
 			}
 		}
 
 		// Update particle renderable properties
-		for (int i = 0; i < particle_system_component.GetParticlesAlive(); i++)
+		for (uint32_t i = 0; i < particle_system_component.GetParticlesAlive(); i++)
 		{
 			const auto& particle = particle_system_component.GetParticles()[i];
 			if(particle.time_alive >= particle.life_span) 
 			{
-				m_render_packet->deleted_objects.push_back(particle_system_component.m_particle_renderable_objects[i]);
+				stream.packet.deleted_objects.push_back(particle_system_component.m_particle_renderable_objects[i].Share());
 				continue;
 			}
 
-			if (particle_system_component.IsBillBoard())
-			{
-				// Local
-				transpose_view[12] = transform.model_matrix.data[12];
-				transpose_view[13] = transform.model_matrix.data[13];
-				transpose_view[14] = transform.model_matrix.data[14];
-
-				auto& renderable_object = particle_system_component.m_particle_renderable_objects[i];
-				renderable_object->model_matrix =
-					transpose_view *
-					yoyo::TranslationMat4x4(particles[i].position) *
-					yoyo::TransposeMat4x4(yoyo::QuatToMat4x4(yoyo::QuatFromAxisAngle(yoyo::Vec3{0.0f, 0.0f, 1.0f}, particles[i].rotation.z))) *
-					yoyo::ScaleMat4x4(particles[i].scale);
-				renderable_object->color = particles[i].color;
-			}
-			else
-			{
-				auto& renderable_object = particle_system_component.m_particle_renderable_objects[i];
-				renderable_object->model_matrix = transform.model_matrix * yoyo::TranslationMat4x4(particles[i].position);
-			}
+			update_renderable(i);
 		}
-	}
-
-	m_renderer_layer->SendRenderPacket(m_render_packet);
+	});
 }
 
 void ParticleSystemManager::OnComponentCreated(Entity entity, ParticleSystemComponent* particle_system_component)
@@ -303,7 +300,7 @@ void ParticleSystemManager::OnComponentCreated(Entity entity, ParticleSystemComp
 		particle_system_component->m_particle_renderable_objects.resize(particle_system_component->GetMaxParticles());
 		for (int i = 0; i < particle_system_component->m_particle_renderable_objects.size(); i++)
 		{
-			particle_system_component->m_particle_renderable_objects[i] = CreateRef<yoyo::MeshPassObject>();
+			particle_system_component->m_particle_renderable_objects[i] = RenderObject<yoyo::MeshPassObject>::Create();
 			particle_system_component->m_particle_renderable_objects[i]->mesh = quad;
 			particle_system_component->m_particle_renderable_objects[i]->material = material;
 		}
@@ -323,11 +320,54 @@ void ParticleSystemManager::OnComponentDestroyed(Entity e, ParticleSystemCompone
 	// 	}
 	// }
 
+	// Valid is written by the renderer while a frame is sent
+	m_pipeline->Join();
+
+	RenderStream& stream = m_pipeline->Stream(RenderStreamType::Particles);
 	for(auto& renderable : particle_system_component->m_particle_renderable_objects)
 	{
 		if (renderable->Valid())
 		{
-			m_render_packet->deleted_objects.push_back(renderable);
+			stream.packet.deleted_objects.push_back(renderable.Share());
+		}
+	}
+}
+
+void ParticleSystemManager::OnDisableBatch(const std::vector<entt::entity>& entities)
+{
+	// Valid is written by the renderer while a frame is sent
+	m_pipeline->Join();
+
+	RenderStream& stream = m_pipeline->Stream(RenderStreamType::Particles);
+	for (entt::entity id : entities)
+	{
+		ParticleSystemComponent* particle_system_component = GetScene()->Registry().try_get<ParticleSystemComponent>(id);
+		if (!particle_system_component)
+		{
+			continue;
+		}
+
+		for (auto& renderable : particle_system_component->m_particle_renderable_objects)
+		{
+			if (renderable->Valid())
+			{
+				stream.packet.deleted_objects.push_back(renderable.Share());
+			}
+		}
+
+		particle_system_component->m_particle_system->SetParticlesAlive(0);
+	}
+}
+
+void ParticleSystemManager::OnDestroyBatch(const std::vector<entt::entity>& entities)
+{
+	// Renderables of disabled particle systems were withdrawn when disabled
+	for (entt::entity id : entities)
+	{
+		ParticleSystemComponent* particle_system_component = GetScene()->Registry().try_get<ParticleSystemComponent>(id);
+		if (particle_system_component && !GetScene()->IsEnabled(id))
+		{
+			particle_system_component->m_particle_renderable_objects.clear();
 		}
 	}
 }
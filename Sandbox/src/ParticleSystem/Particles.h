@@ -8,14 +8,14 @@
 
 namespace yoyo
 {
-    class RendererLayer;
     class ParticleSystem;
 }
 
+class RenderPipeline;
+
 struct ParticleSystemComponent
 {
     ParticleSystemComponent();
-    ~ParticleSystemComponent();
 
     const std::vector<yoyo::Particle>& GetParticles() const;
 
@@ -66,7 +66,7 @@ private:
     Ref<yoyo::ParticleSystem> m_particle_system;
 
     // Instance rendering
-    std::vector<Ref<yoyo::MeshPassObject>> m_particle_renderable_objects = {};
+    std::vector<RenderObject<yoyo::MeshPassObject>> m_particle_renderable_objects = {};
 
     // Materials
     std::vector<Ref<yoyo::Material>> m_materials;
@@ -79,20 +79,25 @@ private:
 class ParticleSystemManager : public System<ParticleSystemComponent>
 {
 public:
-    ParticleSystemManager(Scene* scene, yoyo::RendererLayer* renderer_layer)
-        :System<ParticleSystemComponent>(scene), m_renderer_layer(renderer_layer) {}
+    // Fills the pipeline's particle stream
+    ParticleSystemManager(Scene* scene, RenderPipeline* pipeline)
+        :System<ParticleSystemComponent>(scene), m_pipeline(pipeline) {}
 
     virtual ~ParticleSystemManager() = default;
 
     virtual void OnInit() override;
     virtual void OnShutdown() override;
     virtual void OnUpdate(float dt) override;
+    virtual TaskAccess Access() const override;
 
     virtual void OnComponentCreated(Entity e, ParticleSystemComponent* transform) override;
     virtual void OnComponentDestroyed(Entity e, ParticleSystemComponent* transform) override;
 private:
-    yoyo::RenderPacket* m_render_packet = nullptr;
-    yoyo::RendererLayer* m_renderer_layer = nullptr;
+    // Disabled particle systems are cleared, their renderables are withdrawn until they emit again
+    void OnDisableBatch(const std::vector<entt::entity>& entities);
+    void OnDestroyBatch(const std::vector<entt::entity>& entities);
+private:
+    RenderPipeline* m_pipeline = nullptr;
 
     std::vector<Ref<yoyo::ParticleSystem>> m_particle_systems;
 };
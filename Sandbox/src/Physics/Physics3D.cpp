@@ -132,6 +132,14 @@ namespace psx
 		PxRigidStatic* groundPlane = PxCreatePlane(*m_physics, PxPlane(0, 1, 0, 0), *m_material);
 		m_scene->addActor(*groundPlane);
 
+		GetScene()->OnDestroyBatch().connect<&PhysicsWorld::OnDestroyBatch>(this);
+		GetScene()->OnDisableBatch().connect<&PhysicsWorld::OnDisableBatch>(this);
+		GetScene()->OnEnableBatch().connect<&PhysicsWorld::OnEnableBatch>(this);
+		GetScene()->OnSnapshot().connect<&PhysicsWorld::OnSnapshot>(this);
+		GetScene()->OnRestore().connect<&PhysicsWorld::OnRestore>(this);
+
+		GetScene()->Pack<TransformComponent, RigidBodyComponent>();
+
 		// for (PxU32 i = 0;i < 5;i++)
 		// {
 		// 	CreateStack(PxTransform(PxVec3(0, 0, stackZ -= 10.0f)), 10, 2.0f);
@@ -143,6 +151,12 @@ namespace psx
 
 	void PhysicsWorld::OnShutdown()
 	{
+		GetScene()->OnDestroyBatch().disconnect<&PhysicsWorld::OnDestroyBatch>(this);
+		GetScene()->OnDisableBatch().disconnect<&PhysicsWorld::OnDisableBatch>(this);
+		GetScene()->OnEnableBatch().disconnect<&PhysicsWorld::OnEnableBatch>(this);
+		GetScene()->OnSnapshot().disconnect<&PhysicsWorld::OnSnapshot>(this);
+		GetScene()->OnRestore().disconnect<&PhysicsWorld::OnRestore>(this);
+
 		PX_RELEASE(m_physics);
 		PX_RELEASE(m_dispatcher);
 		PX_RELEASE(m_physics);
@@ -174,17 +188,20 @@ namespace psx
 
 		{
 			using namespace physx;
-			for (auto entity : GetScene()->Registry().group<TransformComponent, RigidBodyComponent>())
+			GetScene()->Each<TransformComponent, RigidBodyComponent>([](TransformComponent& transform, const RigidBodyComponent& rb)
 			{
-				Entity e(entity, GetScene());
-				const RigidBodyComponent& rb = e.GetComponent<RigidBodyComponent>();
+				// Sleeping bodies have not moved, leave their transforms clean
+				if (physx::PxRigidDynamic* body = rb.actor->is<physx::PxRigidDynamic>(); body && body->isSleeping())
+				{
+					return;
+				}
 
 				// Update transforms
 				PxTransform t = rb.actor->getGlobalPose();
-				TransformComponent& transform = e.GetComponent<TransformComponent>();
 				transform.position = { t.p.x, t.p.y, t.p.z };
 				transform.quat_rotation = { t.q.x, t.q.y, t.q.z, t.q.w };
-			}
+				transform.MarkDirty();
+			});
 		}
 	}
 
@@ -206,14 +223,154 @@ namespace psx
 
 	void PhysicsWorld::OnComponentDestroyed(Entity e, RigidBodyComponent* rb)
 	{
-		using namespace physx;
-		const TransformComponent& transform = e.GetComponent<TransformComponent>();
-		PxTransform t = { {transform.position.x, transform.position.y, transform.position.z}, PxQuat{transform.quat_rotation.x, transform.quat_rotation.y, transform.quat_rotation.z, transform.quat_rotation.w}};
+		// Already released with its destruction batch
+		if (!rb->actor)
+		{
+			return;
+		}
 
 		// Implicit release of shapes
 		rb->actor->release();
 	}
 
+	void PhysicsWorld::OnDestroyBatch(const std::vector<entt::entity>& entities)
+	{
+		using namespace physx;
+
+		// Actors of disabled bodies are already out of the scene
+		m_removed_actors.clear();
+		for (entt::entity id : entities)
+		{
+			RigidBodyComponent* rb = GetScene()->Registry().try_get<RigidBodyComponent>(id);
+			if (rb && rb->actor && rb->actor->getScene())
+			{
+				m_removed_actors.push_back(rb->actor);
+			}
+		}
+
+		if (!m_removed_actors.empty())
+		{
+			m_scene->removeActors(m_removed_actors.data(), static_cast<PxU32>(m_removed_actors.size()));
+		}
+
+		for (entt::entity id : entities)
+		{
+			RigidBodyComponent* rb = GetScene()->Registry().try_get<RigidBodyComponent>(id);
+			if (rb && rb->actor)
+			{
+				// Implicit release of shapes
+				rb->actor->release();
+				rb->actor = nullptr;
+			}
+		}
+	}
+
+	void PhysicsWorld::OnDisableBatch(const std::vector<entt::entity>& entities)
+	{
+		using namespace physx;
+
+		m_removed_actors.clear();
+		for (entt::entity id : entities)
+		{
+			RigidBodyComponent* rb = GetScene()->Registry().try_get<RigidBodyComponent>(id);
+			if (rb && rb->actor && rb->actor->getScene())
+			{
+				m_removed_actors.push_back(rb->actor);
+			}
+		}
+
+		if (!m_removed_actors.empty())
+		{
+			m_scene->removeActors(m_removed_actors.data(), static_cast<PxU32>(m_removed_actors.size()));
+		}
+	}
+
+	void PhysicsWorld::OnEnableBatch(const std::vector<entt::entity>& entities)
+	{
+		using namespace physx;
+
+		m_removed_actors.clear();
+		for (entt::entity id : entities)
+		{
+			RigidBodyComponent* rb = GetScene()->Registry().try_get<RigidBodyComponent>(id);
+			if (!rb || !rb->actor || rb->actor->getScene())
+			{
+				continue;
+			}
+
+			// The transform may have been reset while the body was parked
+			const TransformComponent& transform = GetScene()->Registry().get<TransformComponent>(id);
+			rb->actor->setGlobalPose({{transform.position.x, transform.position.y, transform.position.z},
+									{transform.quat_rotation.x, transform.quat_rotation.y, transform.quat_rotation.z, transform.quat_rotation.w }});
+
+			if (PxRigidDynamic* dynamic = rb->actor->is<PxRigidDynamic>())
+			{
+				dynamic->setLinearVelocity(PxVec3(0));
+				dynamic->setAngularVelocity(PxVec3(0));
+			}
+
+			m_removed_actors.push_back(rb->actor);
+		}
+
+		if (!m_removed_actors.empty())
+		{
+			m_scene->addActors(m_removed_actors.data(), static_cast<PxU32>(m_removed_actors.size()));
+		}
+	}
+
+	void PhysicsWorld::OnSnapshot(SceneState& state)
+	{
+		using namespace physx;
+
+		// Bodies out of the physics scene are disabled, they rejoin at their transform when enabled
+		std::vector<BodyRecord>& records = state.Records<BodyRecord>();
+		GetScene()->Registry().view<RigidBodyComponent>().each([&](entt::entity id, const RigidBodyComponent& rb)
+		{
+			PxRigidDynamic* dynamic = rb.actor ? rb.actor->is<PxRigidDynamic>() : nullptr;
+			if (!dynamic || !dynamic->getScene())
+			{
+				return;
+			}
+
+			records.push_back({ id, dynamic->getGlobalPose(), dynamic->getLinearVelocity(), dynamic->getAngularVelocity(), dynamic->isSleeping() });
+		});
+	}
+
+	void PhysicsWorld::OnRestore(const SceneState& state)
+	{
+		using namespace physx;
+
+		const std::vector<BodyRecord>* records = state.Find<BodyRecord>();
+		if (!records)
+		{
+			return;
+		}
+
+		entt::registry& registry = GetScene()->Registry();
+		for (const BodyRecord& record : *records)
+		{
+			RigidBodyComponent* rb = registry.valid(record.id) ? registry.try_get<RigidBodyComponent>(record.id) : nullptr;
+			PxRigidDynamic* dynamic = rb && rb->actor ? rb->actor->is<PxRigidDynamic>() : nullptr;
+			if (!dynamic || !dynamic->getScene())
+			{
+				continue;
+			}
+
+			dynamic->setGlobalPose(record.pose, false);
+			dynamic->setLinearVelocity(record.linear_velocity, false);
+			dynamic->setAngularVelocity(record.angular_velocity, false);
+
+			if (record.sleeping)
+			{
+				dynamic->putToSleep();
+			}
+			else
+			{
+				dynamic->wakeUp();
+			}
+		}
+	}
+
 	void SimulationEventCallback::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count)
 	{
 		YINFO("physics trigger event!");
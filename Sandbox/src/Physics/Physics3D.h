@@ -33,8 +33,22 @@ namespace psx
         virtual void OnShutdown() override;
         virtual void OnUpdate(float dt) override;
 
+        // Collision callbacks run scripts, which may touch anything
+        virtual TaskAccess Access() const override { return TaskAccess::Exclusive(); }
+
         virtual void OnComponentCreated(Entity e, RigidBodyComponent* rb) override;
         virtual void OnComponentDestroyed(Entity e, RigidBodyComponent* rb) override;
+
+        // Removes the actors of a destruction batch from the scene in one call
+        void OnDestroyBatch(const std::vector<entt::entity>& entities);
+
+        // Disabled bodies leave the scene and rejoin it at their current transform when enabled
+        void OnDisableBatch(const std::vector<entt::entity>& entities);
+        void OnEnableBatch(const std::vector<entt::entity>& entities);
+
+        // Captures and restores the poses and velocities of dynamic bodies in the physics scene with the scene's state
+        void OnSnapshot(SceneState& state);
+        void OnRestore(const SceneState& state);
     public:
         // Actor functions
         void AttachBoxShape(RigidBodyComponent& rb, const yoyo::Vec3& extents, physx::PxBoxGeometry** box_shape, PhysicsMaterial* material = nullptr);
@@ -55,5 +69,17 @@ namespace psx
         physx::PxPvd* m_pvd;
 
         SimulationEventCallback* m_simulation_event_callback;
+
+        // Scratch list for batched actor removal and insertion
+        std::vector<physx::PxActor*> m_removed_actors;
+
+        struct BodyRecord
+        {
+            entt::entity id;
+            physx::PxTransform pose;
+            physx::PxVec3 linear_velocity;
+            physx::PxVec3 angular_velocity;
+            bool sleeping;
+        };
     };
 }
\ No newline at end of file
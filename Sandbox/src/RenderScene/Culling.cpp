@@ -0,0 +1,213 @@
+#include "Culling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <Renderer/Mesh.h>
+#include <Renderer/SkinnedMesh.h>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define Y_CULL_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define Y_CULL_SSE
+#endif
+
+template<typename Vertices>
+static BoundingSphere VerticesBounds(const Vertices& vertices)
+{
+    if (vertices.empty())
+    {
+        return { {}, std::numeric_limits<float>::infinity() };
+    }
+
+    // Centered on the box around the vertices, loose but found in two passes
+    yoyo::Vec3 min = vertices[0].position;
+    yoyo::Vec3 max = vertices[0].position;
+    for (const auto& vertex : vertices)
+    {
+        min.x = std::min(min.x, vertex.position.x);
+        min.y = std::min(min.y, vertex.position.y);
+        min.z = std::min(min.z, vertex.position.z);
+        max.x = std::max(max.x, vertex.position.x);
+        max.y = std::max(max.y, vertex.position.y);
+        max.z = std::max(max.z, vertex.position.z);
+    }
+
+    BoundingSphere bounds;
+    bounds.center = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+
+    float radius_sqr = 0.0f;
+    for (const auto& vertex : vertices)
+    {
+        float dx = vertex.position.x - bounds.center.x;
+        float dy = vertex.position.y - bounds.center.y;
+        float dz = vertex.position.z - bounds.center.z;
+        radius_sqr = std::max(radius_sqr, dx * dx + dy * dy + dz * dz);
+    }
+
+    bounds.radius = std::sqrt(radius_sqr);
+    return bounds;
+}
+
+BoundingSphere MeshBounds(const Ref<yoyo::IMesh>& mesh)
+{
+    if (!mesh)
+    {
+        return { {}, std::numeric_limits<float>::infinity() };
+    }
+
+    if (mesh->GetMeshType() == yoyo::MeshType::Skinned)
+    {
+        return VerticesBounds(std::static_pointer_cast<yoyo::SkinnedMesh>(mesh)->GetVertices());
+    }
+
+    return VerticesBounds(std::static_pointer_cast<yoyo::StaticMesh>(mesh)->GetVertices());
+}
+
+BoundingSphere TransformBounds(const BoundingSphere& bounds, const yoyo::Mat4x4& model_matrix)
+{
+    // Column major, translation in the last column
+    const float* m = model_matrix.data;
+    const yoyo::Vec3& c = bounds.center;
+
+    BoundingSphere world;
+    world.center.x = m[0] * c.x + m[4] * c.y + m[8] * c.z + m[12];
+    world.center.y = m[1] * c.x + m[5] * c.y + m[9] * c.z + m[13];
+    world.center.z = m[2] * c.x + m[6] * c.y + m[10] * c.z + m[14];
+
+    float scale_sqr = std::max({
+        m[0] * m[0] + m[1] * m[1] + m[2] * m[2],
+        m[4] * m[4] + m[5] * m[5] + m[6] * m[6],
+        m[8] * m[8] + m[9] * m[9] + m[10] * m[10] });
+    world.radius = bounds.radius * std::sqrt(scale_sqr);
+
+    return world;
+}
+
+Frustum Frustum::FromViewProjection(const yoyo::Mat4x4& view_proj)
+{
+    // Planes are sums of the matrix rows (Gribb/Hartmann)
+    const float* m = view_proj.data;
+    auto row = [m](int i, int j) { return m[j * 4 + i]; };
+
+    Frustum frustum;
+    for (int j = 0; j < 4; j++)
+    {
+        frustum.planes[0][j] = row(3, j) + row(0, j); // Left
+        frustum.planes[1][j] = row(3, j) - row(0, j); // Right
+        frustum.planes[2][j] = row(3, j) + row(1, j); // Bottom
+        frustum.planes[3][j] = row(3, j) - row(1, j); // Top
+        frustum.planes[4][j] = row(3, j) + row(2, j); // Near, behind the true near plane for [0, 1] depth which only keeps more
+        frustum.planes[5][j] = row(3, j) - row(2, j); // Far
+    }
+
+    // Normalized so plane distances compare with radii
+    for (float* plane : frustum.planes)
+    {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f)
+        {
+            for (int j = 0; j < 4; j++)
+            {
+                plane[j] /= length;
+            }
+        }
+    }
+
+    return frustum;
+}
+
+Frustum ShadowCasterFrustum(const Frustum& frustum, const yoyo::Vec3& direction)
+{
+    Frustum casters = frustum;
+    for (float* plane : casters.planes)
+    {
+        if (plane[0] * direction.x + plane[1] * direction.y + plane[2] * direction.z > 0.0f)
+        {
+            // Rejects no sphere of finite radius
+            plane[0] = 0.0f;
+            plane[1] = 0.0f;
+            plane[2] = 0.0f;
+            plane[3] = std::numeric_limits<float>::max();
+        }
+    }
+
+    return casters;
+}
+
+uint32_t CullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius, uint32_t count, uint8_t* visible)
+{
+    uint32_t visible_count = 0;
+
+#if defined(Y_CULL_AVX)
+    const __m256 zero = _mm256_setzero_ps();
+    for (uint32_t i = 0; i < count; i += 8)
+    {
+        const __m256 cx = _mm256_loadu_ps(x + i);
+        const __m256 cy = _mm256_loadu_ps(y + i);
+        const __m256 cz = _mm256_loadu_ps(z + i);
+        const __m256 r = _mm256_loadu_ps(radius + i);
+
+        __m256 outside = zero;
+        for (const float* plane : frustum.planes)
+        {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane[0])), _mm256_mul_ps(cy, _mm256_set1_ps(plane[1])));
+            d = _mm256_add_ps(d, _mm256_mul_ps(cz, _mm256_set1_ps(plane[2])));
+            d = _mm256_add_ps(d, _mm256_add_ps(r, _mm256_set1_ps(plane[3])));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, zero, _CMP_LT_OQ));
+        }
+
+        int mask = ~_mm256_movemask_ps(outside);
+        for (uint32_t lane = 0; lane < 8; lane++)
+        {
+            uint8_t lane_visible = static_cast<uint8_t>((mask >> lane) & 1);
+            visible[i + lane] = lane_visible;
+            visible_count += lane_visible;
+        }
+    }
+#elif defined(Y_CULL_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        const __m128 cx = _mm_loadu_ps(x + i);
+        const __m128 cy = _mm_loadu_ps(y + i);
+        const __m128 cz = _mm_loadu_ps(z + i);
+        const __m128 r = _mm_loadu_ps(radius + i);
+
+        __m128 outside = zero;
+        for (const float* plane : frustum.planes)
+        {
+            __m128 d = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane[0])), _mm_mul_ps(cy, _mm_set1_ps(plane[1])));
+            d = _mm_add_ps(d, _mm_mul_ps(cz, _mm_set1_ps(plane[2])));
+            d = _mm_add_ps(d, _mm_add_ps(r, _mm_set1_ps(plane[3])));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(d, zero));
+        }
+
+        int mask = ~_mm_movemask_ps(outside);
+        for (uint32_t lane = 0; lane < 4; lane++)
+        {
+            uint8_t lane_visible = static_cast<uint8_t>((mask >> lane) & 1);
+            visible[i + lane] = lane_visible;
+            visible_count += lane_visible;
+        }
+    }
+#else
+    for (uint32_t i = 0; i < count; i++)
+    {
+        bool outside = false;
+        for (const float* plane : frustum.planes)
+        {
+            float d = plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3] + radius[i];
+            outside |= d < 0.0f;
+        }
+
+        visible[i] = outside ? 0 : 1;
+        visible_count += outside ? 0 : 1;
+    }
+#endif
+
+    return visible_count;
+}
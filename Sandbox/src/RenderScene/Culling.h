@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Core/Memory.h>
+#include <Math/Math.h>
+
+namespace yoyo
+{
+    class IMesh;
+}
+
+// Spheres are tested this many at a time, arrays passed to CullSpheres are padded to a multiple of it
+constexpr uint32_t CULL_BATCH = 8;
+
+struct BoundingSphere
+{
+    yoyo::Vec3 center = {};
+
+    // Infinite for meshes without vertex data, which are never culled
+    float radius = 0.0f;
+};
+
+// Sphere around the mesh's vertices in mesh space, skinned meshes are bound in bind pose
+BoundingSphere MeshBounds(const Ref<yoyo::IMesh>& mesh);
+
+// Bounds of the sphere once placed by model_matrix, scaled by the largest axis
+BoundingSphere TransformBounds(const BoundingSphere& bounds, const yoyo::Mat4x4& model_matrix);
+
+// Inward facing planes (a, b, c, d) of a view projection, points with ax + by + cz + d < 0 are outside
+struct Frustum
+{
+    float planes[6][4];
+
+    static Frustum FromViewProjection(const yoyo::Mat4x4& view_proj);
+};
+
+// Frustum of the spheres whose shadows cast along direction, i.e. a directional light's, can fall into frustum.
+// Planes facing the direction are dropped, moving a sphere along it brings the sphere inside them.
+Frustum ShadowCasterFrustum(const Frustum& frustum, const yoyo::Vec3& direction);
+
+// Writes 1 to visible for spheres touching the frustum and 0 otherwise, count must be a multiple of CULL_BATCH.
+// Spheres with NaN or negative infinite radii are respectively kept and culled.
+// Returns the number of visible spheres.
+uint32_t CullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius, uint32_t count, uint8_t* visible);
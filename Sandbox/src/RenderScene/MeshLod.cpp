@@ -0,0 +1,156 @@
+#include "MeshLod.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include <Core/Log.h>
+#include <Renderer/Mesh.h>
+#include <Renderer/SkinnedMesh.h>
+
+#include "Assets/MeshFile.h"
+
+uint32_t MeshLodChain::Select(float screen_size, uint32_t current) const
+{
+    if (Count() == 0)
+    {
+        return 0;
+    }
+
+    uint32_t lod = std::min(current, Count() - 1);
+
+    while (lod + 1 < Count() && screen_size < screen_sizes[lod + 1])
+    {
+        lod++;
+    }
+
+    while (lod > 0 && screen_size >= screen_sizes[lod] * (1.0f + LOD_HYSTERESIS))
+    {
+        lod--;
+    }
+
+    return lod;
+}
+
+void MeshLodChain::SyncBones() const
+{
+    if (meshes.empty() || meshes[0]->GetMeshType() != yoyo::MeshType::Skinned)
+    {
+        return;
+    }
+
+    Ref<yoyo::SkinnedMesh> source = std::static_pointer_cast<yoyo::SkinnedMesh>(meshes[0]);
+    for (uint32_t lod = 1; lod < Count(); lod++)
+    {
+        std::static_pointer_cast<yoyo::SkinnedMesh>(meshes[lod])->bones = source->bones;
+    }
+}
+
+template<typename VertexType>
+static std::vector<VertexType> GatherVertices(const std::vector<VertexType>& source, const std::vector<uint32_t>& source_vertices)
+{
+    std::vector<VertexType> vertices;
+    vertices.reserve(source_vertices.size());
+    for (uint32_t vertex : source_vertices)
+    {
+        vertices.push_back(source[vertex]);
+    }
+
+    return vertices;
+}
+
+// Level vertices are taken from the source mesh rather than the file, so skinned levels keep their bone weights
+static Ref<yoyo::IMesh> CreateLodMesh(const Ref<yoyo::IMesh>& mesh, uint32_t lod, MeshFile& file)
+{
+    const std::string name = mesh->name + "_lod" + std::to_string(lod);
+
+    if (mesh->GetMeshType() == yoyo::MeshType::Skinned)
+    {
+        Ref<yoyo::SkinnedMesh> source = std::static_pointer_cast<yoyo::SkinnedMesh>(mesh);
+        Ref<yoyo::SkinnedMesh> lod_mesh = yoyo::SkinnedMesh::Create(name);
+        lod_mesh->GetVertices() = GatherVertices(source->GetVertices(), file.source_vertices);
+        lod_mesh->GetIndices() = std::move(file.indices);
+        lod_mesh->skeletal_hierarchy = source->skeletal_hierarchy;
+        lod_mesh->bones = source->bones;
+        return lod_mesh;
+    }
+
+    Ref<yoyo::StaticMesh> source = std::static_pointer_cast<yoyo::StaticMesh>(mesh);
+    Ref<yoyo::StaticMesh> lod_mesh = yoyo::StaticMesh::Create(name);
+    lod_mesh->GetVertices() = GatherVertices(source->GetVertices(), file.source_vertices);
+    lod_mesh->GetIndices() = std::move(file.indices);
+    return lod_mesh;
+}
+
+static uint32_t VertexCount(const Ref<yoyo::IMesh>& mesh)
+{
+    if (mesh->GetMeshType() == yoyo::MeshType::Skinned)
+    {
+        return static_cast<uint32_t>(std::static_pointer_cast<yoyo::SkinnedMesh>(mesh)->GetVertices().size());
+    }
+
+    return static_cast<uint32_t>(std::static_pointer_cast<yoyo::StaticMesh>(mesh)->GetVertices().size());
+}
+
+static uint32_t IndexCount(const Ref<yoyo::IMesh>& mesh)
+{
+    if (mesh->GetMeshType() == yoyo::MeshType::Skinned)
+    {
+        return static_cast<uint32_t>(std::static_pointer_cast<yoyo::SkinnedMesh>(mesh)->GetIndices().size());
+    }
+
+    return static_cast<uint32_t>(std::static_pointer_cast<yoyo::StaticMesh>(mesh)->GetIndices().size());
+}
+
+Ref<MeshLodChain> LoadMeshLods(const Ref<yoyo::IMesh>& mesh)
+{
+    if (!mesh)
+    {
+        return nullptr;
+    }
+
+    // Keyed by address like the culling bounds, meshes without levels are cached as null
+    static std::unordered_map<const yoyo::IMesh*, std::pair<WeakRef<yoyo::IMesh>, Ref<MeshLodChain>>> s_chains;
+
+    auto& [mesh_ref, cached] = s_chains[mesh.get()];
+    if (mesh_ref.lock() == mesh)
+    {
+        return cached;
+    }
+
+    mesh_ref = mesh;
+    cached = nullptr;
+
+    Ref<MeshLodChain> chain = CreateRef<MeshLodChain>();
+    chain->meshes.push_back(mesh);
+    chain->screen_sizes.push_back(DEFAULT_LOD_SCREEN_SIZES[0]);
+    chain->index_counts.push_back(IndexCount(mesh));
+
+    const std::string path = "assets/meshes/" + mesh->name + ".ymesh";
+    for (uint32_t lod = 1; lod < MAX_MESH_LODS; lod++)
+    {
+        MeshFile file;
+        if (!ReadMeshFile(MeshLodPath(path, lod), file))
+        {
+            break;
+        }
+
+        // Levels of an older export refer to vertices that no longer exist
+        if (file.source_vertices.empty() || file.source_vertex_count != VertexCount(mesh))
+        {
+            YWARN("Mesh LOD %u of %s does not match its mesh, regenerate it with CapitalPunishmentMeshLod!", lod, mesh->name.c_str());
+            break;
+        }
+
+        chain->index_counts.push_back(static_cast<uint32_t>(file.indices.size()));
+        chain->meshes.push_back(CreateLodMesh(mesh, lod, file));
+        chain->screen_sizes.push_back(DEFAULT_LOD_SCREEN_SIZES[lod]);
+    }
+
+    if (chain->Count() > 1)
+    {
+        cached = chain;
+    }
+
+    return cached;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Core/Memory.h>
+
+namespace yoyo
+{
+    class IMesh;
+}
+
+constexpr uint32_t MAX_MESH_LODS = 4;
+
+// Coarser levels swap in below these fractions of the screen height, level 0 is always allowed
+constexpr float DEFAULT_LOD_SCREEN_SIZES[MAX_MESH_LODS] = { 1.0f, 0.25f, 0.1f, 0.04f };
+
+// Levels only get finer again once the object is this much larger than the threshold it crossed
+constexpr float LOD_HYSTERESIS = 0.15f;
+
+// Levels of detail of one mesh, shared by every mesh renderer drawing it
+struct MeshLodChain
+{
+    // Level 0 is the source mesh, coarser levels draw fewer triangles over the subset of its vertices they use
+    std::vector<Ref<yoyo::IMesh>> meshes;
+
+    // Level i is drawn once the object covers less than screen_sizes[i] of the screen height, descending
+    std::vector<float> screen_sizes;
+
+    // Indices drawn by each level
+    std::vector<uint32_t> index_counts;
+
+    uint32_t Count() const { return static_cast<uint32_t>(meshes.size()); }
+
+    // Level for an object covering screen_size of the screen height, drawn at current before
+    uint32_t Select(float screen_size, uint32_t current) const;
+
+    // Skinned levels are posed with the bones the animator writes to the source mesh
+    void SyncBones() const;
+};
+
+// Fraction of the screen height covered by a sphere, projection_scale is the projection's y scale, i.e. [1][1]
+inline float ScreenSize(float radius, float distance, float projection_scale)
+{
+    return distance > radius ? radius * projection_scale / distance : 1.0f;
+}
+
+// Loads the levels written by the mesh LOD tool next to assets/meshes/<mesh name>.ymesh, chains are cached by mesh.
+// Returns null for meshes without levels.
+Ref<MeshLodChain> LoadMeshLods(const Ref<yoyo::IMesh>& mesh);
@@ -0,0 +1,82 @@
+#include "RenderBatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+DrawKey MakeDrawKey(uint64_t batch, float depth)
+{
+    // Bits of non negative floats order like the floats, the top bits keep the order at reduced precision
+    depth = std::max(depth, 0.0f);
+
+    uint32_t depth_bits;
+    memcpy(&depth_bits, &depth, sizeof(depth_bits));
+
+    return (batch << DRAW_KEY_DEPTH_BITS) | (depth_bits >> (32 - DRAW_KEY_DEPTH_BITS - 1));
+}
+
+void RadixSort(std::vector<DrawKey>& keys, std::vector<uint32_t>& values, std::vector<DrawKey>& key_scratch, std::vector<uint32_t>& value_scratch)
+{
+    const size_t count = keys.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    key_scratch.resize(count);
+    value_scratch.resize(count);
+
+    // Histograms of every byte in one pass
+    uint32_t histograms[8][256] = {};
+    for (DrawKey key : keys)
+    {
+        for (uint32_t pass = 0; pass < 8; pass++)
+        {
+            histograms[pass][(key >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    for (uint32_t pass = 0; pass < 8; pass++)
+    {
+        uint32_t* histogram = histograms[pass];
+
+        // Every key has the same digit
+        if (histogram[(keys[0] >> (pass * 8)) & 0xff] == count)
+        {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t digit = 0; digit < 256; digit++)
+        {
+            uint32_t digit_count = histogram[digit];
+            histogram[digit] = offset;
+            offset += digit_count;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t destination = histogram[(keys[i] >> (pass * 8)) & 0xff]++;
+            key_scratch[destination] = keys[i];
+            value_scratch[destination] = values[i];
+        }
+
+        keys.swap(key_scratch);
+        values.swap(value_scratch);
+    }
+}
+
+void BuildBatches(const std::vector<DrawKey>& sorted_keys, std::vector<RenderBatch>& batches)
+{
+    batches.clear();
+
+    for (uint32_t i = 0; i < sorted_keys.size(); i++)
+    {
+        if (!batches.empty() && DrawKeyBatch(batches.back().key) == DrawKeyBatch(sorted_keys[i]))
+        {
+            batches.back().count++;
+            continue;
+        }
+
+        batches.push_back({ sorted_keys[i], i, 1 });
+    }
+}
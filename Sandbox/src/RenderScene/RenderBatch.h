@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Sorts visible mesh objects by pass, material, mesh and then depth. Bits, high to low:
+// pass (8) | material (16) | mesh (16) | depth (24)
+using DrawKey = uint64_t;
+
+constexpr uint32_t DRAW_KEY_DEPTH_BITS = 24;
+constexpr uint32_t DRAW_KEY_MESH_BITS = 16;
+constexpr uint32_t DRAW_KEY_MATERIAL_BITS = 16;
+constexpr uint32_t DRAW_KEY_PASS_BITS = 8;
+
+// Objects whose keys match above the depth bits are drawn as one instanced batch
+inline uint64_t DrawKeyBatch(DrawKey key) { return key >> DRAW_KEY_DEPTH_BITS; }
+
+// Pass, material and mesh bits, ids are truncated to their field
+inline uint64_t MakeDrawKeyBatch(uint32_t pass, uint32_t material, uint32_t mesh)
+{
+    return (static_cast<uint64_t>(pass & ((1u << DRAW_KEY_PASS_BITS) - 1)) << (DRAW_KEY_MATERIAL_BITS + DRAW_KEY_MESH_BITS)) |
+        (static_cast<uint64_t>(material & ((1u << DRAW_KEY_MATERIAL_BITS) - 1)) << DRAW_KEY_MESH_BITS) |
+        static_cast<uint64_t>(mesh & ((1u << DRAW_KEY_MESH_BITS) - 1));
+}
+
+// Near to far within a batch, depth is a non negative distance
+DrawKey MakeDrawKey(uint64_t batch, float depth);
+
+// Sorts keys ascending and moves values along, stable. Scratch buffers are resized as needed and kept by callers between frames.
+// Byte passes whose digit is the same for every key are skipped.
+void RadixSort(std::vector<DrawKey>& keys, std::vector<uint32_t>& values, std::vector<DrawKey>& key_scratch, std::vector<uint32_t>& value_scratch);
+
+// Range of sorted objects drawn with one instanced draw
+struct RenderBatch
+{
+    DrawKey key;
+    uint32_t begin;
+    uint32_t count;
+};
+
+// Splits sorted keys into batches of equal pass, material and mesh
+void BuildBatches(const std::vector<DrawKey>& sorted_keys, std::vector<RenderBatch>& batches);
+
+struct BatchStats
+{
+    uint32_t objects = 0;
+    uint32_t batches = 0;
+    uint32_t largest = 0;
+
+    float ObjectsPerBatch() const { return batches > 0 ? static_cast<float>(objects) / batches : 0.0f; }
+};
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Core/Assert.h>
+#include <Core/Memory.h>
+
+// Fixed size blocks carved from chunks, freed blocks are reused first.
+// Blocks are freed by the last reference to their object, i.e. from the render thread, so allocation is locked.
+class RenderBlockArena
+{
+public:
+    static constexpr uint32_t CHUNK_BLOCKS = 256;
+
+    RenderBlockArena() = default;
+    ~RenderBlockArena() = default;
+
+    RenderBlockArena(const RenderBlockArena&) = delete;
+    RenderBlockArena& operator=(const RenderBlockArena&) = delete;
+
+    void* Allocate(size_t size, size_t align)
+    {
+        YASSERT(align <= alignof(std::max_align_t), "Render object is over aligned!");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_block_words == 0)
+        {
+            m_block_words = (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        }
+        YASSERT(size <= m_block_words * sizeof(std::max_align_t), "Render arena serves a single block size!");
+
+        if (m_free.empty())
+        {
+            m_chunks.push_back(std::make_unique<std::max_align_t[]>(m_block_words * CHUNK_BLOCKS));
+
+            // Handed out front to back
+            std::max_align_t* chunk = m_chunks.back().get();
+            for (uint32_t i = CHUNK_BLOCKS; i > 0; i--)
+            {
+                m_free.push_back(chunk + (i - 1) * m_block_words);
+            }
+        }
+
+        void* block = m_free.back();
+        m_free.pop_back();
+        return block;
+    }
+
+    void Free(void* block)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(block);
+    }
+private:
+    std::mutex m_mutex;
+    size_t m_block_words = 0;
+    std::vector<std::unique_ptr<std::max_align_t[]>> m_chunks;
+    std::vector<void*> m_free;
+};
+
+// Allocates shared objects and their reference counts side by side in an arena
+template<typename T>
+struct RenderBlockAllocator
+{
+    using value_type = T;
+
+    explicit RenderBlockAllocator(RenderBlockArena* arena)
+        :arena(arena) {}
+
+    template<typename U>
+    RenderBlockAllocator(const RenderBlockAllocator<U>& other)
+        :arena(other.arena) {}
+
+    T* allocate(size_t n)
+    {
+        YASSERT(n == 1, "Render arena allocates one object at a time!");
+        return static_cast<T*>(arena->Allocate(sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        arena->Free(p);
+    }
+
+    template<typename U>
+    bool operator==(const RenderBlockAllocator<U>& other) const { return arena == other.arena; }
+    template<typename U>
+    bool operator!=(const RenderBlockAllocator<U>& other) const { return arena != other.arena; }
+
+    RenderBlockArena* arena;
+};
+
+// Generational index of an object in its RenderObjectPool, stale once the object is released
+template<typename T>
+struct RenderHandle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    // Returns null if the object was released
+    T* Get() const;
+
+    explicit operator bool() const { return Get() != nullptr; }
+    bool operator==(const RenderHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const RenderHandle& other) const { return !(*this == other); }
+};
+
+// Renderer side objects (mesh pass objects, cameras, animators) owned by components.
+// Objects live in contiguous chunks and are reached through handles without touching reference counts,
+// the shared reference the renderer expects is only copied when objects are submitted or withdrawn.
+// Create and Release are structural changes and must not run while systems update.
+template<typename T>
+class RenderObjectPool
+{
+public:
+    static RenderObjectPool& Instance()
+    {
+        // Never destroyed, the renderer may hold the last references at exit
+        static RenderObjectPool* pool = new RenderObjectPool();
+        return *pool;
+    }
+
+    template<typename... Args>
+    RenderHandle<T> Create(Args&&... args)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_free == UINT32_MAX)
+        {
+            uint32_t index = static_cast<uint32_t>(m_slot_chunks.size()) * RenderBlockArena::CHUNK_BLOCKS;
+            m_slot_chunks.push_back(std::make_unique<Slot[]>(RenderBlockArena::CHUNK_BLOCKS));
+
+            for (uint32_t i = RenderBlockArena::CHUNK_BLOCKS; i > 0; i--)
+            {
+                At(index + i - 1).next_free = m_free;
+                m_free = index + i - 1;
+            }
+        }
+
+        uint32_t index = m_free;
+        Slot& slot = At(index);
+        m_free = slot.next_free;
+
+        slot.object = std::allocate_shared<T>(RenderBlockAllocator<T>(&m_arena), std::forward<Args>(args)...);
+        m_size++;
+
+        return { index, slot.generation };
+    }
+
+    // Drops the pool's reference, the object is freed once the renderer drops its own
+    void Release(RenderHandle<T> handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!Valid(handle))
+        {
+            return;
+        }
+
+        Slot& slot = At(handle.index);
+        slot.object.reset();
+        slot.generation++;
+        slot.next_free = m_free;
+        m_free = handle.index;
+        m_size--;
+    }
+
+    T* Get(RenderHandle<T> handle) const
+    {
+        return Valid(handle) ? At(handle.index).object.get() : nullptr;
+    }
+
+    // Reference handed to the renderer, null if the object was released
+    const Ref<T>& Share(RenderHandle<T> handle) const
+    {
+        static const Ref<T> s_null;
+        return Valid(handle) ? At(handle.index).object : s_null;
+    }
+
+    uint32_t Size() const { return m_size; }
+private:
+    RenderObjectPool() = default;
+
+    struct Slot
+    {
+        Ref<T> object;
+        uint32_t generation = 0;
+        uint32_t next_free = UINT32_MAX;
+    };
+
+    Slot& At(uint32_t index) const
+    {
+        return m_slot_chunks[index / RenderBlockArena::CHUNK_BLOCKS][index % RenderBlockArena::CHUNK_BLOCKS];
+    }
+
+    bool Valid(RenderHandle<T> handle) const
+    {
+        return handle.index < m_slot_chunks.size() * RenderBlockArena::CHUNK_BLOCKS && At(handle.index).generation == handle.generation && At(handle.index).object;
+    }
+private:
+    std::mutex m_mutex;
+    RenderBlockArena m_arena;
+
+    std::vector<std::unique_ptr<Slot[]>> m_slot_chunks;
+    uint32_t m_free = UINT32_MAX;
+    uint32_t m_size = 0;
+};
+
+template<typename T>
+T* RenderHandle<T>::Get() const
+{
+    return RenderObjectPool<T>::Instance().Get(*this);
+}
+
+// Owns a pooled object and releases it when destroyed, components hold these in place of shared references
+template<typename T>
+class RenderObject
+{
+public:
+    RenderObject() = default;
+    ~RenderObject() { Reset(); }
+
+    RenderObject(const RenderObject&) = delete;
+    RenderObject& operator=(const RenderObject&) = delete;
+
+    RenderObject(RenderObject&& other) noexcept
+        :m_handle(other.m_handle)
+    {
+        other.m_handle = {};
+    }
+
+    RenderObject& operator=(RenderObject&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_handle = other.m_handle;
+            other.m_handle = {};
+        }
+
+        return *this;
+    }
+
+    template<typename... Args>
+    static RenderObject Create(Args&&... args)
+    {
+        RenderObject object;
+        object.m_handle = RenderObjectPool<T>::Instance().Create(std::forward<Args>(args)...);
+        return object;
+    }
+
+    void Reset()
+    {
+        if (m_handle.index != UINT32_MAX)
+        {
+            RenderObjectPool<T>::Instance().Release(m_handle);
+            m_handle = {};
+        }
+    }
+
+    T* Get() const { return m_handle.Get(); }
+    T* operator->() const { return Get(); }
+    T& operator*() const { return *Get(); }
+    explicit operator bool() const { return Get() != nullptr; }
+
+    // Non owning handle, goes stale when the object is released
+    RenderHandle<T> Handle() const { return m_handle; }
+
+    // Shared reference for the render packet
+    const Ref<T>& Share() const { return RenderObjectPool<T>::Instance().Share(m_handle); }
+private:
+    RenderHandle<T> m_handle;
+};
@@ -0,0 +1,164 @@
+#include "RenderPipeline.h"
+
+#include <Core/Time.h>
+#include <Renderer/RendererLayer.h>
+
+#include "Jobs/JobSystem.h"
+
+RenderPipeline::RenderPipeline(yoyo::RendererLayer* renderer_layer, RenderPipelineMode mode)
+    :m_renderer_layer(renderer_layer), m_mode(mode)
+{
+    for (RenderFrame& frame : m_frames)
+    {
+        for (RenderStream& stream : frame.streams)
+        {
+            stream.packet.ToggleAutoReset(true);
+        }
+    }
+}
+
+RenderPipeline::~RenderPipeline()
+{
+    // Unsent frames are dropped
+    Join();
+}
+
+void RenderPipeline::BeginFrame()
+{
+    if (m_mode != RenderPipelineMode::Pipelined || !m_published)
+    {
+        return;
+    }
+
+    // Handles of the published frame are still valid, objects released from here on are skipped
+    Apply(*m_published);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sending = true;
+    }
+
+    RenderFrame* frame = m_published;
+    if (JobSystem::Instance().WorkerCount() == 0)
+    {
+        Send(*frame);
+        return;
+    }
+
+    JobSystem::Instance().Submit([this, frame]() {
+        Send(*frame);
+    });
+}
+
+void RenderPipeline::EndFrame()
+{
+    {
+        yoyo::ScopedTimer wait_timer([&](const yoyo::ScopedTimer& timer) {
+            m_stats.wait_time = timer.delta;
+        });
+        Join();
+    }
+
+    if (m_published)
+    {
+        Consumed(*m_published);
+        m_published = nullptr;
+    }
+
+    RenderFrame& frame = m_frames[m_write];
+    frame.index = m_next_index++;
+    frame.published = std::chrono::steady_clock::now();
+
+    if (m_mode == RenderPipelineMode::Synchronous)
+    {
+        Apply(frame);
+        Send(frame);
+        Consumed(frame);
+        return;
+    }
+
+    m_published = &frame;
+    m_write = (m_write + 1) % FRAMES;
+}
+
+void RenderPipeline::Join()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_sent.wait(lock, [this]() { return !m_sending; });
+}
+
+void RenderPipeline::ClearStats()
+{
+    m_stats = {};
+    m_total_latency = 0.0;
+}
+
+void RenderPipeline::Apply(RenderFrame& frame)
+{
+    yoyo::ScopedTimer apply_timer([&](const yoyo::ScopedTimer& timer) {
+        m_stats.submit_time = timer.delta;
+    });
+
+    for (RenderStream& stream : frame.streams)
+    {
+        for (const RenderTransformUpdate& update : stream.transforms)
+        {
+            if (yoyo::MeshPassObject* object = update.object.Get())
+            {
+                object->model_matrix = update.model_matrix;
+            }
+        }
+
+        for (const RenderColorUpdate& update : stream.colors)
+        {
+            if (yoyo::MeshPassObject* object = update.object.Get())
+            {
+                object->color = update.color;
+            }
+        }
+
+        stream.transforms.clear();
+        stream.colors.clear();
+    }
+}
+
+void RenderPipeline::Send(RenderFrame& frame)
+{
+    float send_time = 0.0f;
+    {
+        yoyo::ScopedTimer send_timer([&](const yoyo::ScopedTimer& timer) {
+            send_time = timer.delta;
+        });
+
+        for (RenderStream& stream : frame.streams)
+        {
+            // Packets reset themselves once consumed by the renderer
+            if (m_renderer_layer)
+            {
+                m_renderer_layer->SendRenderPacket(&stream.packet);
+                continue;
+            }
+
+            stream.packet.new_objects.clear();
+            stream.packet.deleted_objects.clear();
+            stream.packet.new_dir_lights.clear();
+            stream.packet.new_camera = nullptr;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.submit_time += send_time;
+    m_sending = false;
+    m_sent.notify_all();
+}
+
+void RenderPipeline::Consumed(const RenderFrame& frame)
+{
+    std::chrono::duration<double> latency = std::chrono::steady_clock::now() - frame.published;
+
+    m_stats.frames++;
+    m_stats.latency = static_cast<float>(latency.count());
+
+    m_total_latency += latency.count();
+    m_stats.average_latency = static_cast<float>(m_total_latency / m_stats.frames);
+}
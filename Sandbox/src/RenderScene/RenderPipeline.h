@@ -0,0 +1,140 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <Math/Math.h>
+#include <Renderer/RenderScene.h>
+
+#include "RenderObjectPool.h"
+
+namespace yoyo
+{
+    class RendererLayer;
+}
+
+struct RenderTransformUpdate
+{
+    RenderHandle<yoyo::MeshPassObject> object;
+    yoyo::Mat4x4 model_matrix;
+};
+
+struct RenderColorUpdate
+{
+    RenderHandle<yoyo::MeshPassObject> object;
+    yoyo::Vec4 color;
+};
+
+// What one system hands to the renderer in a frame. Systems fill separate streams so they do not conflict.
+struct RenderStream
+{
+    yoyo::RenderPacket packet;
+
+    // Mesh object writes, applied in order when the frame is submitted
+    std::vector<RenderTransformUpdate> transforms;
+    std::vector<RenderColorUpdate> colors;
+};
+
+enum class RenderStreamType
+{
+    Scene,
+    Particles,
+
+    Count
+};
+
+struct RenderFrame
+{
+    uint64_t index = 0;
+    RenderStream streams[static_cast<uint32_t>(RenderStreamType::Count)];
+
+    // End of the frame's simulation
+    std::chrono::steady_clock::time_point published;
+};
+
+enum class RenderPipelineMode
+{
+    // Frames are submitted as soon as they are simulated
+    Synchronous,
+
+    // Frame N is submitted on a worker while frame N + 1 simulates, the renderer draws one frame behind the simulation
+    Pipelined,
+};
+
+struct RenderPipelineStats
+{
+    uint64_t frames = 0;
+
+    // Seconds from the end of a frame's simulation until the renderer may draw it
+    float latency = 0.0f;
+    float average_latency = 0.0f;
+
+    // Seconds spent applying a frame's updates and sending its packets
+    float submit_time = 0.0f;
+
+    // Seconds the game thread blocked on the submission at the end of a frame
+    float wait_time = 0.0f;
+};
+
+// Double buffered handoff of render packets between the game and the renderer.
+// The game thread fills the write frame while the previous frame is submitted, which gives these ownership rules:
+// - Render packets and object updates of a frame belong to the game thread until EndFrame publishes them, then to the submission.
+// - Mesh object transforms and colors are written only by BeginFrame, so the renderer draws the transforms that match the packets it was sent.
+// - Meshes, materials, cameras and lights stay game thread state, the renderer only reads them once EndFrame has joined the submission.
+// - Game code reading renderer state (i.e. MeshPassObject::Valid) joins the submission first.
+class RenderPipeline
+{
+public:
+    static constexpr uint32_t FRAMES = 2;
+
+    // Headless pipelines drop the packets once submitted. Synchronous by default, the renderer still draws on the game thread
+    // so pipelining only overlaps the submission with the next simulation.
+    RenderPipeline(yoyo::RendererLayer* renderer_layer, RenderPipelineMode mode = RenderPipelineMode::Synchronous);
+    ~RenderPipeline();
+
+    RenderPipeline(const RenderPipeline&) = delete;
+    RenderPipeline& operator=(const RenderPipeline&) = delete;
+
+    // Stream of the frame being simulated
+    RenderStream& Stream(RenderStreamType type) { return m_frames[m_write].streams[static_cast<uint32_t>(type)]; }
+
+    // Applies the object updates of the published frame and starts sending its packets on a worker
+    void BeginFrame();
+
+    // Waits for the submission and publishes the simulated frame, the renderer may draw once this returns
+    void EndFrame();
+
+    // Blocks until no frame is being sent
+    void Join();
+
+    RenderPipelineMode Mode() const { return m_mode; }
+
+    const RenderPipelineStats& Stats() const { return m_stats; }
+    void ClearStats();
+private:
+    void Apply(RenderFrame& frame);
+    void Send(RenderFrame& frame);
+
+    // Records the latency of a frame the renderer may now draw
+    void Consumed(const RenderFrame& frame);
+private:
+    yoyo::RendererLayer* m_renderer_layer;
+    RenderPipelineMode m_mode;
+
+    RenderFrame m_frames[FRAMES];
+    uint32_t m_write = 0;
+    uint64_t m_next_index = 0;
+
+    // Published frame waiting for BeginFrame, or being sent
+    RenderFrame* m_published = nullptr;
+
+    std::mutex m_mutex;
+    std::condition_variable m_sent;
+    bool m_sending = false;
+
+    RenderPipelineStats m_stats;
+    double m_total_latency = 0.0;
+};
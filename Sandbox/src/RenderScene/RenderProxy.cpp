@@ -0,0 +1,144 @@
+#include "RenderProxy.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <Core/Assert.h>
+
+static constexpr float CULLED_RADIUS = -std::numeric_limits<float>::infinity();
+
+RenderProxyId RenderProxyBuffer::Create(RenderHandle<yoyo::MeshPassObject> object, const yoyo::Mat4x4& model_matrix, const BoundingSphere& bounds)
+{
+    RenderProxyId id = m_free;
+    if (id == INVALID_RENDER_PROXY)
+    {
+        id = static_cast<RenderProxyId>(m_objects.size());
+        m_transforms.emplace_back();
+        m_objects.emplace_back();
+        m_local_bounds.emplace_back();
+        m_next_free.push_back(ALIVE);
+        m_dirty_marks.push_back(0);
+
+        if (id >= m_bounds_radius.size())
+        {
+            size_t padded = m_bounds_radius.size() + CULL_BATCH;
+            m_bounds_x.resize(padded, 0.0f);
+            m_bounds_y.resize(padded, 0.0f);
+            m_bounds_z.resize(padded, 0.0f);
+            m_bounds_radius.resize(padded, CULLED_RADIUS);
+        }
+    }
+    else
+    {
+        m_free = m_next_free[id];
+        m_next_free[id] = ALIVE;
+    }
+
+    m_transforms[id] = model_matrix;
+    m_objects[id] = object;
+    m_local_bounds[id] = bounds;
+    SetWorldBounds(id, TransformBounds(bounds, model_matrix));
+    m_size++;
+
+    MarkDirty(id);
+    return id;
+}
+
+void RenderProxyBuffer::Destroy(RenderProxyId id)
+{
+    if (!IsAlive(id))
+    {
+        return;
+    }
+
+    // Dirty marks of freed slots are skipped when ranges are built
+    m_objects[id] = {};
+    m_bounds_radius[id] = CULLED_RADIUS;
+    m_next_free[id] = m_free;
+    m_free = id;
+    m_size--;
+}
+
+void RenderProxyBuffer::SetTransform(RenderProxyId id, const yoyo::Mat4x4& model_matrix)
+{
+    YASSERT(IsAlive(id), "Invalid render proxy!");
+
+    m_transforms[id] = model_matrix;
+    SetWorldBounds(id, TransformBounds(m_local_bounds[id], model_matrix));
+    MarkDirty(id);
+}
+
+void RenderProxyBuffer::SetObject(RenderProxyId id, RenderHandle<yoyo::MeshPassObject> object)
+{
+    YASSERT(IsAlive(id), "Invalid render proxy!");
+
+    m_objects[id] = object;
+}
+
+void RenderProxyBuffer::SetWorldBounds(RenderProxyId id, const BoundingSphere& bounds)
+{
+    m_bounds_x[id] = bounds.center.x;
+    m_bounds_y[id] = bounds.center.y;
+    m_bounds_z[id] = bounds.center.z;
+    m_bounds_radius[id] = bounds.radius;
+}
+
+RenderProxyBounds RenderProxyBuffer::Bounds() const
+{
+    return { m_bounds_x.data(), m_bounds_y.data(), m_bounds_z.data(), m_bounds_radius.data(), static_cast<uint32_t>(m_bounds_radius.size()) };
+}
+
+void RenderProxyBuffer::MarkDirty(RenderProxyId id)
+{
+    if (m_dirty_marks[id])
+    {
+        return;
+    }
+
+    m_dirty_marks[id] = 1;
+    m_dirty.push_back(id);
+    m_ranges_current = false;
+}
+
+const std::vector<RenderProxyRange>& RenderProxyBuffer::DirtyRanges()
+{
+    if (m_ranges_current)
+    {
+        return m_dirty_ranges;
+    }
+
+    std::sort(m_dirty.begin(), m_dirty.end());
+
+    m_dirty_ranges.clear();
+    for (RenderProxyId id : m_dirty)
+    {
+        if (!IsAlive(id))
+        {
+            continue;
+        }
+
+        if (!m_dirty_ranges.empty() && m_dirty_ranges.back().end == id)
+        {
+            m_dirty_ranges.back().end++;
+        }
+        else
+        {
+            m_dirty_ranges.push_back({ id, id + 1 });
+        }
+    }
+
+    m_ranges_current = true;
+    return m_dirty_ranges;
+}
+
+void RenderProxyBuffer::ClearDirty()
+{
+    for (RenderProxyId id : m_dirty)
+    {
+        m_dirty_marks[id] = 0;
+    }
+
+    m_dirty.clear();
+    m_dirty_ranges.clear();
+    m_ranges_current = true;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Math/Math.h>
+#include <Renderer/RenderScene.h>
+
+#include "Culling.h"
+#include "RenderObjectPool.h"
+
+using RenderProxyId = uint32_t;
+constexpr RenderProxyId INVALID_RENDER_PROXY = UINT32_MAX;
+
+// Half open range of proxy slots
+struct RenderProxyRange
+{
+    uint32_t begin;
+    uint32_t end;
+};
+
+// World bounding spheres in slot order, padded to a multiple of CULL_BATCH with spheres that are always culled
+struct RenderProxyBounds
+{
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* radius;
+    uint32_t count;
+};
+
+// Render side mirror of the scene's mesh renderers, one slot per mesh object.
+// Slots keep their id while alive and freed slots are reused first, so the buffers stay dense.
+// Instance transforms are packed in slot order, moved slots are reported as merged dirty ranges so syncing scales with what moved.
+// World bounds are kept as separate coordinate arrays so culling loads several slots at once.
+class RenderProxyBuffer
+{
+public:
+    RenderProxyBuffer() = default;
+    ~RenderProxyBuffer() = default;
+
+    RenderProxyBuffer(const RenderProxyBuffer&) = delete;
+    RenderProxyBuffer& operator=(const RenderProxyBuffer&) = delete;
+
+    // New slots start dirty, bounds are in mesh space
+    RenderProxyId Create(RenderHandle<yoyo::MeshPassObject> object, const yoyo::Mat4x4& model_matrix, const BoundingSphere& bounds);
+    void Destroy(RenderProxyId id);
+
+    // Moves the slot's world bounds along
+    void SetTransform(RenderProxyId id, const yoyo::Mat4x4& model_matrix);
+
+    // Swaps the mesh object the slot draws, i.e. for another level of detail
+    void SetObject(RenderProxyId id, RenderHandle<yoyo::MeshPassObject> object);
+
+    // Slots changed since the last ClearDirty, sorted and merged
+    const std::vector<RenderProxyRange>& DirtyRanges();
+    void ClearDirty();
+
+    bool IsAlive(RenderProxyId id) const { return id < m_objects.size() && m_next_free[id] == ALIVE; }
+
+    // Indexed by proxy id, freed slots hold stale values
+    const yoyo::Mat4x4* Transforms() const { return m_transforms.data(); }
+    const RenderHandle<yoyo::MeshPassObject>* Objects() const { return m_objects.data(); }
+
+    // Freed slots are always culled
+    RenderProxyBounds Bounds() const;
+
+    // Slots ever created, alive or free
+    uint32_t Capacity() const { return static_cast<uint32_t>(m_objects.size()); }
+    uint32_t Size() const { return m_size; }
+private:
+    static constexpr uint32_t ALIVE = UINT32_MAX - 1;
+
+    void MarkDirty(RenderProxyId id);
+    void SetWorldBounds(RenderProxyId id, const BoundingSphere& bounds);
+private:
+    std::vector<yoyo::Mat4x4> m_transforms;
+    std::vector<RenderHandle<yoyo::MeshPassObject>> m_objects;
+    std::vector<BoundingSphere> m_local_bounds;
+
+    // Padded past the slot count
+    std::vector<float> m_bounds_x;
+    std::vector<float> m_bounds_y;
+    std::vector<float> m_bounds_z;
+    std::vector<float> m_bounds_radius;
+
+    // Next slot of the free list, ALIVE for live slots
+    std::vector<uint32_t> m_next_free;
+    uint32_t m_free = INVALID_RENDER_PROXY;
+    uint32_t m_size = 0;
+
+    std::vector<uint8_t> m_dirty_marks;
+    std::vector<RenderProxyId> m_dirty;
+    std::vector<RenderProxyRange> m_dirty_ranges;
+    bool m_ranges_current = true;
+};
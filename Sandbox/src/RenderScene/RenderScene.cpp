@@ -1,65 +1,528 @@
 #include "RenderScene.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include <Renderer/Camera.h>
 #include <Renderer/Light.h>
+#include <Renderer/Material.h>
 
 #include <Math/MatrixTransform.h>
 #include "ECS/Components/Components.h"
 
-MeshSubsystem::MeshSubsystem(Scene* scene, Ref<yoyo::RenderPacket> rp)
-    :System(scene), m_rp_ref(rp) {}
+MeshSubsystem::MeshSubsystem(Scene* scene, RenderPipeline* pipeline)
+    :System(scene), m_pipeline(pipeline)
+{
+    EnableBatchedLifecycle();
+}
 
-void MeshSubsystem::OnComponentCreated(Entity entity, MeshRendererComponent* component) {
-    component->mesh_object = CreateRef<yoyo::MeshPassObject>();
-    component->mesh_object->model_matrix = component->mesh_object->model_matrix;
+void MeshSubsystem::OnComponentsCreated(const std::vector<entt::entity>& entities)
+{
+    entt::registry& registry = GetScene()->Registry();
 
-    auto rp = m_rp_ref.lock();
-    rp->new_objects.push_back(component->mesh_object);
+    // Submitted by the next update if enabled and visible
+    for (entt::entity id : entities)
+    {
+        CreateProxy(id, registry.get<MeshRendererComponent>(id));
+    }
 }
 
 void MeshSubsystem::OnComponentDestroyed(Entity entity, MeshRendererComponent* component)
 {
-    auto rp = m_rp_ref.lock();
-    rp->deleted_objects.push_back(component->mesh_object);
+    // Removed outside a destruction batch
+    DestroyProxy(*component);
+}
+
+void MeshSubsystem::OnInit()
+{
+    GetScene()->OnDisableBatch().connect<&MeshSubsystem::OnDisableBatch>(this);
+    GetScene()->OnEnableBatch().connect<&MeshSubsystem::OnEnableBatch>(this);
+    GetScene()->Track<TransformComponent>(m_transform_changes);
+    GetScene()->Track<MeshRendererComponent>(m_mesh_changes);
+
+    // Culling frustum
+    GetScene()->RegisterSingleton<CameraComponent>();
+}
+
+void MeshSubsystem::OnShutdown()
+{
+    GetScene()->OnDisableBatch().disconnect<&MeshSubsystem::OnDisableBatch>(this);
+    GetScene()->OnEnableBatch().disconnect<&MeshSubsystem::OnEnableBatch>(this);
+    GetScene()->Untrack<TransformComponent>(m_transform_changes);
+    GetScene()->Untrack<MeshRendererComponent>(m_mesh_changes);
+}
+
+void MeshSubsystem::OnUpdate(float dt)
+{
+    entt::registry& registry = GetScene()->Registry();
+
+    // Meshes set on live proxies, the proxy is created again so its bounds and levels of detail follow before it is culled.
+    // The level it drew is withdrawn and the new mesh is submitted by this update if visible.
+    for (entt::entity id : m_mesh_changes.Entities())
+    {
+        MeshRendererComponent* mesh_renderer = registry.valid(id) ? registry.try_get<MeshRendererComponent>(id) : nullptr;
+        if (mesh_renderer && mesh_renderer->proxy != INVALID_RENDER_PROXY)
+        {
+            DestroyProxy(*mesh_renderer);
+            CreateProxy(id, *mesh_renderer);
+        }
+    }
+
+    m_mesh_changes.Clear();
+
+    // Disabled mesh objects are synced too so they are in place when enabled
+    for (entt::entity id : m_transform_changes.Entities())
+    {
+        if (!registry.valid(id))
+        {
+            continue;
+        }
+
+        MeshRendererComponent* mesh_renderer = registry.try_get<MeshRendererComponent>(id);
+        if (mesh_renderer && mesh_renderer->proxy != INVALID_RENDER_PROXY)
+        {
+            m_proxies.SetTransform(mesh_renderer->proxy, registry.get<TransformComponent>(id).model_matrix);
+        }
+    }
+
+    m_transform_changes.Clear();
+
+    // The renderer reads model matrices from the mesh objects, written when the frame is submitted
+    RenderStream& stream = m_pipeline->Stream(RenderStreamType::Scene);
+    const yoyo::Mat4x4* transforms = m_proxies.Transforms();
+    const RenderHandle<yoyo::MeshPassObject>* objects = m_proxies.Objects();
+    for (const RenderProxyRange& range : m_proxies.DirtyRanges())
+    {
+        for (RenderProxyId id = range.begin; id < range.end; id++)
+        {
+            stream.transforms.push_back({ objects[id], transforms[id] });
+        }
+    }
+
+    m_proxies.ClearDirty();
+
+    // Without a camera nothing is culled
+    const RenderProxyBounds bounds = m_proxies.Bounds();
+    m_in_frustum.resize(bounds.count);
+    m_in_shadow_volume.assign(bounds.count, 0);
+
+    Entity camera_entity = GetScene()->Singleton<CameraComponent>();
+    yoyo::Camera* camera = camera_entity ? camera_entity.GetComponent<CameraComponent>().camera.Get() : nullptr;
+    const yoyo::Vec3 eye = camera ? camera->position : yoyo::Vec3{};
+
+    // Without a camera every object is drawn at full detail
+    const float projection_scale = camera ? std::fabs(camera->Projection().data[5]) : 0.0f;
+    if (camera)
+    {
+        Frustum frustum = Frustum::FromViewProjection(camera->Projection() * camera->View());
+        CullSpheres(frustum, bounds.x, bounds.y, bounds.z, bounds.radius, bounds.count, m_in_frustum.data());
+
+        // Objects whose shadows along a directional light can reach the view
+        m_light_cull.resize(bounds.count);
+        GetScene()->Each<DirectionalLightComponent>([&](const DirectionalLightComponent& light) {
+            if (!light.dir_light)
+            {
+                return;
+            }
+
+            const yoyo::Vec4& direction = light.dir_light->direction;
+            CullSpheres(ShadowCasterFrustum(frustum, { direction.x, direction.y, direction.z }), bounds.x, bounds.y, bounds.z, bounds.radius, bounds.count, m_light_cull.data());
+            for (uint32_t i = 0; i < bounds.count; i++)
+            {
+                m_in_shadow_volume[i] |= m_light_cull[i];
+            }
+        });
+    }
+    else
+    {
+        std::fill(m_in_frustum.begin(), m_in_frustum.end(), uint8_t(1));
+    }
+
+    // Only visibility and level changes reach the render packet
+    const RenderObjectPool<yoyo::MeshPassObject>& pool = RenderObjectPool<yoyo::MeshPassObject>::Instance();
+
+    m_visible_proxies.clear();
+    m_posed_chains.clear();
+    m_cull_stats = {};
+    m_lod_stats = {};
+    for (RenderProxyId id = 0; id < m_proxies.Capacity(); id++)
+    {
+        const bool enabled = m_proxies.IsAlive(id) && m_enabled[id];
+        const bool visible = enabled && m_in_frustum[id];
+
+        if (visible && m_proxy_lods[id].chain)
+        {
+            float dx = bounds.x[id] - eye.x;
+            float dy = bounds.y[id] - eye.y;
+            float dz = bounds.z[id] - eye.z;
+            float screen_size = camera ? ScreenSize(bounds.radius[id], std::sqrt(dx * dx + dy * dy + dz * dz), projection_scale) : 1.0f;
+
+            SelectLod(id, screen_size, stream);
+        }
+
+        m_cull_stats.tested += enabled ? 1 : 0;
+        if (visible)
+        {
+            m_visible_proxies.push_back(id);
+        }
+
+        // Culled casters are drawn at the level they were last seen at
+        const bool submit = visible || (enabled && m_in_shadow_volume[id] && CastsShadows(*objects[id].Get()));
+        m_cull_stats.shadow_casters += submit && !visible ? 1 : 0;
+        if (submit == static_cast<bool>(m_submitted[id]))
+        {
+            continue;
+        }
+
+        m_submitted[id] = submit ? 1 : 0;
+        if (submit)
+        {
+            stream.packet.new_objects.push_back(pool.Share(objects[id]));
+        }
+        else
+        {
+            stream.packet.deleted_objects.push_back(pool.Share(objects[id]));
+        }
+    }
+
+    m_cull_stats.visible = static_cast<uint32_t>(m_visible_proxies.size());
+    m_cull_stats.culled = m_cull_stats.tested - m_cull_stats.visible;
+
+    // Coarser levels are posed like the meshes they simplify, once per chain
+    std::sort(m_posed_chains.begin(), m_posed_chains.end());
+    m_posed_chains.erase(std::unique(m_posed_chains.begin(), m_posed_chains.end()), m_posed_chains.end());
+    for (const MeshLodChain* chain : m_posed_chains)
+    {
+        chain->SyncBones();
+    }
+
+    if (m_batching)
+    {
+        SortVisible(eye);
+    }
+}
+
+void MeshSubsystem::SetBatching(bool enabled)
+{
+    m_batching = enabled;
+    if (!enabled)
+    {
+        m_batches.clear();
+        m_batch_stats = {};
+    }
+}
+
+bool MeshSubsystem::CastsShadows(const yoyo::MeshPassObject& object)
+{
+    return object.material && object.material->IsCastingShadows();
+}
+
+void MeshSubsystem::SelectLod(RenderProxyId id, float screen_size, RenderStream& stream)
+{
+    ProxyLod& lod = m_proxy_lods[id];
+    const MeshLodChain& chain = *lod.chain;
+
+    lod.selected = static_cast<uint8_t>(chain.Select(screen_size, lod.selected));
+    if (lod.selected != lod.drawn)
+    {
+        const RenderHandle<yoyo::MeshPassObject> next = lod.objects[lod.selected];
+
+        // Swapped within one packet so the object is drawn every frame
+        if (m_submitted[id])
+        {
+            const RenderObjectPool<yoyo::MeshPassObject>& pool = RenderObjectPool<yoyo::MeshPassObject>::Instance();
+            stream.packet.deleted_objects.push_back(pool.Share(lod.objects[lod.drawn]));
+            stream.packet.new_objects.push_back(pool.Share(next));
+        }
+
+        // The level's object was not moved while another level was drawn
+        stream.transforms.push_back({ next, m_proxies.Transforms()[id] });
+        m_proxies.SetObject(id, next);
+        lod.drawn = lod.selected;
+    }
+
+    m_lod_stats.objects++;
+    m_lod_stats.levels[lod.drawn]++;
+    m_lod_stats.indices += chain.index_counts[lod.drawn];
+    m_lod_stats.full_detail_indices += chain.index_counts[0];
+
+    if (lod.drawn > 0)
+    {
+        m_posed_chains.push_back(&chain);
+    }
 }
 
-CameraSubsystem::CameraSubsystem(Scene * scene, Ref<yoyo::RenderPacket> rp)
-    :System(scene), m_rp_ref(rp) {}
+void MeshSubsystem::SortVisible(const yoyo::Vec3& eye)
+{
+    const RenderProxyBounds bounds = m_proxies.Bounds();
+    const RenderHandle<yoyo::MeshPassObject>* objects = m_proxies.Objects();
+
+    if (m_draw_key_slots.size() < m_proxies.Capacity())
+    {
+        m_draw_key_slots.resize(m_proxies.Capacity());
+    }
+
+    // Ids are never freed, start over before they can run out of their key field within this update
+    const size_t max_ids = size_t(1) << std::min(DRAW_KEY_MATERIAL_BITS, DRAW_KEY_MESH_BITS);
+    if (std::max(m_material_ids.size(), m_mesh_ids.size()) + m_visible_proxies.size() > max_ids)
+    {
+        m_material_ids.clear();
+        m_mesh_ids.clear();
+        std::fill(m_draw_key_slots.begin(), m_draw_key_slots.end(), DrawKeySlot{});
+    }
+
+    m_draw_keys.clear();
+    for (RenderProxyId id : m_visible_proxies)
+    {
+        // Proxies draw the mesh object of their current level
+        const yoyo::MeshPassObject& object = *objects[id].Get();
+
+        float dx = bounds.x[id] - eye.x;
+        float dy = bounds.y[id] - eye.y;
+        float dz = bounds.z[id] - eye.z;
+        m_draw_keys.push_back(MakeDrawKey(DrawKeyBatchOf(id, object.material.get(), object.mesh.get()), dx * dx + dy * dy + dz * dz));
+    }
+
+    RadixSort(m_draw_keys, m_visible_proxies, m_draw_key_scratch, m_visible_scratch);
+    BuildBatches(m_draw_keys, m_batches);
+
+    m_batch_stats = {};
+    m_batch_stats.objects = static_cast<uint32_t>(m_visible_proxies.size());
+    m_batch_stats.batches = static_cast<uint32_t>(m_batches.size());
+    for (const RenderBatch& batch : m_batches)
+    {
+        m_batch_stats.largest = std::max(m_batch_stats.largest, batch.count);
+    }
+}
+
+uint64_t MeshSubsystem::DrawKeyBatchOf(RenderProxyId id, const yoyo::Material* material, const yoyo::IMesh* mesh)
+{
+    // Reused slots keep their bits if the new object shares mesh and material
+    DrawKeySlot& slot = m_draw_key_slots[id];
+    if (slot.valid && slot.material == material && slot.mesh == mesh)
+    {
+        return slot.batch;
+    }
+
+    // Static and skinned meshes are drawn by separate passes
+    uint32_t pass = mesh ? static_cast<uint32_t>(mesh->GetMeshType()) : 0;
+
+    slot.valid = true;
+    slot.material = material;
+    slot.mesh = mesh;
+    slot.batch = MakeDrawKeyBatch(pass, DrawId(m_material_ids, slot.material), DrawId(m_mesh_ids, slot.mesh));
+    return slot.batch;
+}
+
+uint32_t MeshSubsystem::DrawId(std::unordered_map<const void*, uint32_t>& ids, const void* resource)
+{
+    auto [it, inserted] = ids.emplace(resource, static_cast<uint32_t>(ids.size()));
+    return it->second;
+}
+
+void MeshSubsystem::OnComponentsDestroyed(const std::vector<entt::entity>& entities)
+{
+    entt::registry& registry = GetScene()->Registry();
+
+    for (entt::entity id : entities)
+    {
+        DestroyProxy(registry.get<MeshRendererComponent>(id));
+    }
+}
+
+void MeshSubsystem::OnDisableBatch(const std::vector<entt::entity>& entities)
+{
+    entt::registry& registry = GetScene()->Registry();
+
+    // Entities whose creation is pending have no proxy yet, their proxy starts disabled
+    for (entt::entity id : entities)
+    {
+        MeshRendererComponent* component = registry.try_get<MeshRendererComponent>(id);
+        if (component && component->proxy != INVALID_RENDER_PROXY)
+        {
+            m_enabled[component->proxy] = 0;
+        }
+    }
+}
+
+void MeshSubsystem::OnEnableBatch(const std::vector<entt::entity>& entities)
+{
+    entt::registry& registry = GetScene()->Registry();
+
+    for (entt::entity id : entities)
+    {
+        MeshRendererComponent* component = registry.try_get<MeshRendererComponent>(id);
+        if (component && component->proxy != INVALID_RENDER_PROXY)
+        {
+            m_enabled[component->proxy] = 1;
+        }
+    }
+}
+
+const BoundingSphere& MeshSubsystem::LocalBounds(const Ref<yoyo::IMesh>& mesh)
+{
+    // Never culled
+    static const BoundingSphere s_unbounded = MeshBounds(nullptr);
+    if (!mesh)
+    {
+        return s_unbounded;
+    }
+
+    // Keyed by address, entries of freed meshes are recomputed if the address is reused
+    auto& [mesh_ref, bounds] = m_mesh_bounds[mesh.get()];
+    if (mesh_ref.lock() != mesh)
+    {
+        mesh_ref = mesh;
+        bounds = MeshBounds(mesh);
+    }
+
+    return bounds;
+}
+
+void MeshSubsystem::CreateProxy(entt::entity id, MeshRendererComponent& component)
+{
+    // Transforms that do not move again are never marked changed, the new proxy is synced by the next update
+    const TransformComponent* transform = GetScene()->Registry().try_get<TransformComponent>(id);
+    component.proxy = m_proxies.Create(component.mesh_object.Handle(), transform ? transform->model_matrix : yoyo::Mat4x4{}, LocalBounds(component.GetMesh()));
+
+    if (component.proxy >= m_enabled.size())
+    {
+        m_enabled.resize(component.proxy + 1);
+        m_submitted.resize(component.proxy + 1);
+        m_proxy_lods.resize(component.proxy + 1);
+    }
+
+    m_enabled[component.proxy] = GetScene()->IsEnabled(id) ? 1 : 0;
+    m_submitted[component.proxy] = 0;
+
+    // New mesh objects start at full detail, coarser levels get mesh objects of their own
+    ProxyLod& lod = m_proxy_lods[component.proxy];
+    lod = {};
+    lod.chain = component.lods;
+    lod.objects[0] = component.mesh_object.Handle();
+
+    component.lod_objects.clear();
+    for (uint32_t level = 1; component.lods && level < component.lods->Count(); level++)
+    {
+        RenderObject<yoyo::MeshPassObject> object = RenderObject<yoyo::MeshPassObject>::Create();
+        object->mesh = component.lods->meshes[level];
+        object->material = component.GetMaterial();
+        object->color = component.mesh_object->color;
+
+        lod.objects[level] = object.Handle();
+        component.lod_objects.push_back(std::move(object));
+    }
+}
+
+void MeshSubsystem::DestroyProxy(MeshRendererComponent& component)
+{
+    if (component.proxy == INVALID_RENDER_PROXY)
+    {
+        return;
+    }
+
+    // Withdrawn if the last update submitted it, at the level it was drawn
+    const Ref<yoyo::MeshPassObject>& object = RenderObjectPool<yoyo::MeshPassObject>::Instance().Share(m_proxies.Objects()[component.proxy]);
+    if (m_submitted[component.proxy] && object)
+    {
+        m_pipeline->Stream(RenderStreamType::Scene).packet.deleted_objects.push_back(object);
+    }
+
+    m_submitted[component.proxy] = 0;
+    m_proxy_lods[component.proxy] = {};
+    m_proxies.Destroy(component.proxy);
+    component.proxy = INVALID_RENDER_PROXY;
+    component.lod_objects.clear();
+}
+
+CameraSubsystem::CameraSubsystem(Scene * scene, RenderPipeline* pipeline)
+    :System(scene), m_pipeline(pipeline) {}
+
+void CameraSubsystem::OnInit()
+{
+    GetScene()->Track<TransformComponent>(m_transform_changes);
+    GetScene()->Track<CameraComponent>(m_camera_changes);
+
+    // Main camera, read by the editor viewport every frame
+    GetScene()->RegisterSingleton<CameraComponent>();
+}
+
+void CameraSubsystem::OnShutdown()
+{
+    GetScene()->Untrack<TransformComponent>(m_transform_changes);
+    GetScene()->Untrack<CameraComponent>(m_camera_changes);
+}
 
 void CameraSubsystem::OnComponentCreated(Entity entity,
     CameraComponent* component) {
-    auto cam = component->camera = CreateRef<yoyo::Camera>();
+    component->camera = RenderObject<yoyo::Camera>::Create();
+
+    m_pipeline->Stream(RenderStreamType::Scene).packet.new_camera = component->camera.Share();
 
-    auto rp = m_rp_ref.lock();
-    rp->new_camera = cam;
+    GetScene()->MarkChanged<CameraComponent>(entity);
 }
 
 void CameraSubsystem::OnComponentDestroyed(Entity e, CameraComponent* component)
 {
 }
 
-void CameraSubsystem::OnUpdate(float dt) 
+// Calls fn for the entities of both change sets that still have T and clears the sets, disabled entities included so they are current when enabled
+template<typename T, typename Fn>
+static void EachChanged(Scene* scene, ChangeSet& transform_changes, ChangeSet& component_changes, Fn&& fn)
 {
-    // Update camera matrices
-    for (auto& id : GetScene()->Registry().view<TransformComponent, CameraComponent>())
+    entt::registry& registry = scene->Registry();
+
+    for (ChangeSet* changes : { &transform_changes, &component_changes })
     {
-        Entity e{ id, GetScene()};
+        for (entt::entity id : changes->Entities())
+        {
+            if (!registry.valid(id))
+            {
+                continue;
+            }
 
-        Ref<yoyo::Camera> cam = e.GetComponent<CameraComponent>().camera;
-        cam->position = e.GetComponent<TransformComponent>().position;
-        cam->UpdateCameraVectors();
+            T* component = registry.try_get<T>(id);
+            if (component)
+            {
+                fn(registry.get<TransformComponent>(id), *component);
+            }
+        }
+
+        changes->Clear();
     }
 }
 
-DirectionalLightSubsystem::DirectionalLightSubsystem(Scene* scene, Ref<yoyo::RenderPacket> rp)
-    :System(scene), m_rp_ref(rp){}
+void CameraSubsystem::OnUpdate(float dt) 
+{
+    // Update camera matrices
+    EachChanged<CameraComponent>(GetScene(), m_transform_changes, m_camera_changes, [](const TransformComponent& transform, CameraComponent& camera) {
+        camera.camera->position = transform.position;
+        camera.camera->UpdateCameraVectors();
+    });
+}
+
+DirectionalLightSubsystem::DirectionalLightSubsystem(Scene* scene, RenderPipeline* pipeline)
+    :System(scene), m_pipeline(pipeline){}
+
+void DirectionalLightSubsystem::OnInit()
+{
+    GetScene()->Track<TransformComponent>(m_transform_changes);
+    GetScene()->Track<DirectionalLightComponent>(m_light_changes);
+}
+
+void DirectionalLightSubsystem::OnShutdown()
+{
+    GetScene()->Untrack<TransformComponent>(m_transform_changes);
+    GetScene()->Untrack<DirectionalLightComponent>(m_light_changes);
+}
 
 void DirectionalLightSubsystem::OnComponentCreated(Entity e, DirectionalLightComponent* component)
 {
     auto dir_light = component->dir_light = CreateRef<yoyo::DirectionalLight>();
 
-    auto rp = m_rp_ref.lock();
-    rp->new_dir_lights.emplace_back(dir_light);
+    m_pipeline->Stream(RenderStreamType::Scene).packet.new_dir_lights.emplace_back(dir_light);
+
+    GetScene()->MarkChanged<DirectionalLightComponent>(e);
 }
 
 void DirectionalLightSubsystem::OnComponentDestroyed(Entity e, DirectionalLightComponent* component)
@@ -69,10 +532,9 @@ void DirectionalLightSubsystem::OnComponentDestroyed(Entity e, DirectionalLightC
 void DirectionalLightSubsystem::OnUpdate(float dt) 
 {
     // Lights
-    for (auto& id : GetScene()->Registry().view<TransformComponent, DirectionalLightComponent>())
+    EachChanged<DirectionalLightComponent>(GetScene(), m_transform_changes, m_light_changes, [](const TransformComponent& transform, DirectionalLightComponent& light)
     {
-        Entity e{ id,  GetScene()};
-        Ref<yoyo::DirectionalLight> dir_light = e.GetComponent<DirectionalLightComponent>().dir_light;
+        Ref<yoyo::DirectionalLight> dir_light = light.dir_light;
 
         // TODO: calculate base of transform
         // yoyo::Vec3 front = Normalize(dir_light.direction);
@@ -87,19 +549,17 @@ void DirectionalLightSubsystem::OnUpdate(float dt)
 
         yoyo::Mat4x4 proj = yoyo::OrthographicProjectionMat4x4(-half_width, half_width, -half_height, half_height, -1000, 1000);
         proj[5] *= -1.0f;
-        dir_light->view_proj = proj * yoyo::LookAtMat4x4(e.GetComponent<TransformComponent>().position, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
-    }
+        dir_light->view_proj = proj * yoyo::LookAtMat4x4(transform.position, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+    });
 }
 
-RenderSceneSystem::RenderSceneSystem(Scene* scene, yoyo::RendererLayer* renderer_layer)
-    :System(scene), m_renderer_layer(renderer_layer)
+RenderSceneSystem::RenderSceneSystem(Scene* scene, RenderPipeline* pipeline)
+    :System(scene)
 {
-    m_render_packet = CreateRef<yoyo::RenderPacket>();
-    m_render_packet->ToggleAutoReset(true);
-
-    AddSubsystem(Ref<DirectionalLightSubsystem>(YNEW DirectionalLightSubsystem(scene, m_render_packet)));
-    AddSubsystem(Ref<CameraSubsystem>(YNEW CameraSubsystem(scene, m_render_packet)));
-    AddSubsystem(Ref<MeshSubsystem>(YNEW MeshSubsystem(scene, m_render_packet)));
+    AddSubsystem(Ref<DirectionalLightSubsystem>(YNEW DirectionalLightSubsystem(scene, pipeline)));
+    AddSubsystem(Ref<CameraSubsystem>(YNEW CameraSubsystem(scene, pipeline)));
+    m_mesh_subsystem = Ref<MeshSubsystem>(YNEW MeshSubsystem(scene, pipeline));
+    AddSubsystem(m_mesh_subsystem);
 }
 
 RenderSceneSystem::~RenderSceneSystem() {}
@@ -112,7 +572,10 @@ void RenderSceneSystem::OnShutdown()
 {
 }
 
-void RenderSceneSystem::OnUpdate(float dt)
+TaskAccess RenderSceneSystem::Access() const
 {
-    m_renderer_layer->SendRenderPacket(m_render_packet.get());
+    // Mesh, camera and light subsystems update from transforms and fill the scene stream of the render pipeline
+    return TaskAccess()
+        .Read<TransformComponent>()
+        .Write<MeshRendererComponent, CameraComponent, DirectionalLightComponent>();
 }
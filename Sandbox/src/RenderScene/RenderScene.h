@@ -3,59 +3,213 @@
 #include "ECS/Components/RenderableComponents.h"
 #include "ECS/System.h"
 
-#include <Renderer/RendererLayer.h>
+#include "MeshLod.h"
+#include "RenderBatch.h"
+#include "RenderPipeline.h"
+#include "RenderProxy.h"
+
+#include <unordered_map>
+
+// Mesh objects tested against the main camera's frustum in the last update, disabled ones excluded
+struct CullStats
+{
+    uint32_t tested = 0;
+    uint32_t visible = 0;
+    uint32_t culled = 0;
+
+    // Culled but still submitted because their shadows can fall into the view
+    uint32_t shadow_casters = 0;
+};
+
+// Visible mesh objects with levels of detail in the last update and the indices they draw
+struct LodStats
+{
+    uint32_t objects = 0;
+    uint32_t levels[MAX_MESH_LODS] = {};
+
+    uint64_t indices = 0;
+    uint64_t full_detail_indices = 0;
+
+    // Factor by which levels of detail cut the vertex work of these objects
+    float Reduction() const { return indices > 0 ? static_cast<float>(full_detail_indices) / indices : 1.0f; }
+};
 
 class MeshSubsystem : public System<MeshRendererComponent>
 {
 public:
     ~MeshSubsystem() = default;
+
+    virtual void OnInit() override;
+    virtual void OnShutdown() override;
+
+    // Writes moved transforms to their proxies and queues the dirty proxy ranges for their mesh objects,
+    // then culls the proxies against the main camera, picks the levels of detail of the visible ones from their size on screen,
+    // submits or withdraws the mesh objects whose visibility changed and, with batching on, sorts the visible ones into instanced batches.
+    // The render packet feeds every pass, so culled shadow casters whose shadows can fall into the view stay submitted.
+    virtual void OnUpdate(float dt) override;
+
+    // Off by default, the renderer draws the render packet in its own order. Turned on by consumers of Batches().
+    void SetBatching(bool enabled);
+    bool IsBatching() const { return m_batching; }
+
+    // Proxies of the mesh objects in view, in draw order with batching on, i.e. by pass, material, mesh and distance to the camera
+    const std::vector<RenderProxyId>& Visible() const { return m_visible_proxies; }
+
+    // Ranges of Visible() sharing pass, material and mesh, one instanced draw each. Empty with batching off.
+    const std::vector<RenderBatch>& Batches() const { return m_batches; }
+
+    const CullStats& Stats() const { return m_cull_stats; }
+    const BatchStats& Batching() const { return m_batch_stats; }
+    const LodStats& Lods() const { return m_lod_stats; }
 protected:
-    virtual void OnComponentCreated(Entity e, MeshRendererComponent* component) override;
     virtual void OnComponentDestroyed(Entity e, MeshRendererComponent* component)  override;
+
+    // Mesh objects are submitted to and withdrawn from the render packet in bulk
+    virtual void OnComponentsCreated(const std::vector<entt::entity>& entities) override;
+    virtual void OnComponentsDestroyed(const std::vector<entt::entity>& entities) override;
 private:
     friend class RenderSceneSystem;
-    MeshSubsystem(Scene* scene, Ref<yoyo::RenderPacket> rp);
-    WeakRef<yoyo::RenderPacket> m_rp_ref;
+    MeshSubsystem(Scene* scene, RenderPipeline* pipeline);
+
+    // Disabled mesh objects are withdrawn from the render packet by the next update and resubmitted once enabled and visible
+    void OnDisableBatch(const std::vector<entt::entity>& entities);
+    void OnEnableBatch(const std::vector<entt::entity>& entities);
+
+    // Mesh space bounds, computed once per mesh
+    const BoundingSphere& LocalBounds(const Ref<yoyo::IMesh>& mesh);
+
+    void CreateProxy(entt::entity id, MeshRendererComponent& component);
+    void DestroyProxy(MeshRendererComponent& component);
+
+    // Sorts the visible proxies by draw key and splits them into batches
+    void SortVisible(const yoyo::Vec3& eye);
+
+    static bool CastsShadows(const yoyo::MeshPassObject& object);
+
+    // Level of detail of a visible proxy, a switch swaps the proxy's mesh object
+    void SelectLod(RenderProxyId id, float screen_size, RenderStream& stream);
+
+    // Pass, material and mesh bits of a proxy's draw key, recomputed when its mesh or material changes
+    uint64_t DrawKeyBatchOf(RenderProxyId id, const yoyo::Material* material, const yoyo::IMesh* mesh);
+    static uint32_t DrawId(std::unordered_map<const void*, uint32_t>& ids, const void* resource);
+
+    RenderPipeline* m_pipeline;
+    ChangeSet m_transform_changes;
+    ChangeSet m_mesh_changes;
+    RenderProxyBuffer m_proxies;
+
+    std::unordered_map<const yoyo::IMesh*, std::pair<WeakRef<yoyo::IMesh>, BoundingSphere>> m_mesh_bounds;
+
+    // Indexed by proxy id, culling results are padded like the proxy bounds
+    std::vector<uint8_t> m_enabled;
+    std::vector<uint8_t> m_submitted;
+    std::vector<uint8_t> m_in_frustum;
+    std::vector<uint8_t> m_in_shadow_volume;
+    std::vector<uint8_t> m_light_cull;
+
+    std::vector<RenderProxyId> m_visible_proxies;
+    CullStats m_cull_stats;
+
+    // Levels of detail by proxy id. Each level is drawn by its own mesh object so a submitted object's mesh never changes,
+    // switching levels withdraws the old object and submits the new one in the same packet.
+    struct ProxyLod
+    {
+        Ref<MeshLodChain> chain;
+
+        // Level 0 is the mesh renderer's own mesh object, coarser levels are its lod_objects
+        RenderHandle<yoyo::MeshPassObject> objects[MAX_MESH_LODS];
+
+        uint8_t selected = 0;
+        uint8_t drawn = 0;
+    };
+
+    std::vector<ProxyLod> m_proxy_lods;
+    std::vector<const MeshLodChain*> m_posed_chains;
+    LodStats m_lod_stats;
+
+    struct DrawKeySlot
+    {
+        const void* material = nullptr;
+        const void* mesh = nullptr;
+        uint64_t batch = 0;
+        bool valid = false;
+    };
+
+    // Small ids of materials and meshes for draw keys, reset before a field runs out of ids
+    std::unordered_map<const void*, uint32_t> m_material_ids;
+    std::unordered_map<const void*, uint32_t> m_mesh_ids;
+    std::vector<DrawKeySlot> m_draw_key_slots;
+
+    std::vector<DrawKey> m_draw_keys;
+    std::vector<DrawKey> m_draw_key_scratch;
+    std::vector<RenderProxyId> m_visible_scratch;
+    std::vector<RenderBatch> m_batches;
+    BatchStats m_batch_stats;
+    bool m_batching = false;
 };
 
 class CameraSubsystem : public System<CameraComponent>
 {
 public:
     ~CameraSubsystem() = default;
+
+    virtual void OnInit() override;
+    virtual void OnShutdown() override;
 protected:
     virtual void OnComponentCreated(Entity e, CameraComponent* component) override;
     virtual void OnComponentDestroyed(Entity e, CameraComponent* component) override;
     virtual void OnUpdate(float dt) override;
 private:
     friend class RenderSceneSystem;
-    CameraSubsystem(Scene* scene, Ref<yoyo::RenderPacket> rp);
-    WeakRef<yoyo::RenderPacket> m_rp_ref;
+    CameraSubsystem(Scene* scene, RenderPipeline* pipeline);
+    RenderPipeline* m_pipeline;
+
+    // Cameras are only updated when moved or patched, i.e. by the camera controller
+    ChangeSet m_transform_changes;
+    ChangeSet m_camera_changes;
 };
 
 class DirectionalLightSubsystem : public System<DirectionalLightComponent>
 {
 public:
     ~DirectionalLightSubsystem() = default;
+
+    virtual void OnInit() override;
+    virtual void OnShutdown() override;
 protected:
     virtual void OnComponentCreated(Entity e, DirectionalLightComponent* component) override;
     virtual void OnComponentDestroyed(Entity e, DirectionalLightComponent* component) override;
     virtual void OnUpdate(float dt) override;
 private:
     friend class RenderSceneSystem;
-    DirectionalLightSubsystem(Scene* scene, Ref<yoyo::RenderPacket> rp);
-    WeakRef<yoyo::RenderPacket> m_rp_ref;
+    DirectionalLightSubsystem(Scene* scene, RenderPipeline* pipeline);
+    RenderPipeline* m_pipeline;
+
+    // Light matrices are only rebuilt when moved or patched
+    ChangeSet m_transform_changes;
+    ChangeSet m_light_changes;
 };
 
 class RenderSceneSystem : public System<>
 {
 public:
-    RenderSceneSystem(Scene* scene, yoyo::RendererLayer* renderer_layer);
+    // Fills the pipeline's scene stream, the pipeline hands it to the renderer
+    RenderSceneSystem(Scene* scene, RenderPipeline* pipeline);
     virtual ~RenderSceneSystem();
 
     virtual void OnInit() override;
     virtual void OnShutdown() override;
-    virtual void OnUpdate(float dt) override;
+    virtual TaskAccess Access() const override;
+
+    const CullStats& Culling() const { return m_mesh_subsystem->Stats(); }
+
+    // Instanced batches of the visible mesh objects, ranges of VisibleMeshes(). Sorted only while batching is on, see MeshSubsystem::SetBatching.
+    void SetBatching(bool enabled) { m_mesh_subsystem->SetBatching(enabled); }
+    const std::vector<RenderProxyId>& VisibleMeshes() const { return m_mesh_subsystem->Visible(); }
+    const std::vector<RenderBatch>& Batches() const { return m_mesh_subsystem->Batches(); }
+    const BatchStats& Batching() const { return m_mesh_subsystem->Batching(); }
+
+    const LodStats& Lods() const { return m_mesh_subsystem->Lods(); }
 private:
-    Ref<yoyo::RenderPacket> m_render_packet;
-    yoyo::RendererLayer* m_renderer_layer;
+    Ref<MeshSubsystem> m_mesh_subsystem;
 };
@@ -5,28 +5,187 @@
 
 #include "Core/Application.h"
 #include "ECS/Entity.h "
+#include "Jobs/JobSystem.h"
+
+// Levels smaller than this are cheaper to update on the calling thread
+static const uint32_t PARALLEL_LEVEL_THRESHOLD = 2048;
+static const uint32_t PARALLEL_BATCH_SIZE = 512;
+
+// Runs fn over ranges of nodes in the level, across workers if the level is large
+template<typename T, typename Fn>
+static void ForEachBatch(std::vector<T>& level, Fn&& fn)
+{
+	if (level.size() < PARALLEL_LEVEL_THRESHOLD)
+	{
+		fn(level.data(), level.data() + level.size());
+		return;
+	}
+
+	JobSystem::Instance().ParallelFor(static_cast<uint32_t>(level.size()), PARALLEL_BATCH_SIZE, [&](uint32_t begin, uint32_t end)
+	{
+		fn(level.data() + begin, level.data() + end);
+	});
+}
 
 void SceneGraph::OnInit()
 {
+	// Adopt transforms created before the scene graph, i.e. the scene root
+	for (auto entity : GetScene()->Registry().view<TransformComponent>())
+	{
+		GetScene()->Registry().get<TransformComponent>(entity).m_scene_graph = this;
+	}
+
+	TransformComponent& root = GetScene()->Root().GetComponent<TransformComponent>();
+	if (root.m_graph_slot == INVALID_GRAPH_SLOT)
+	{
+		InsertSubtree(root);
+	}
 }
 
 void SceneGraph::OnShutdown()
 {
-	// Unsubscribe
+	for (auto entity : GetScene()->Registry().view<TransformComponent>())
+	{
+		TransformComponent& transform = GetScene()->Registry().get<TransformComponent>(entity);
+		transform.m_scene_graph = nullptr;
+		transform.m_graph_slot = INVALID_GRAPH_SLOT;
+		transform.m_queued = false;
+	}
+
+	m_levels.clear();
+	m_dirty_queue.clear();
+	m_dirty_levels.clear();
 }
 
 void SceneGraph::OnUpdate(float dt)
 {
-	Entity e{ 0, GetScene() };
-	TransformComponent& transform = e.GetComponent<TransformComponent>();
-	RecursiveUpdate(e);
-	//RecursiveUpdate(GetScene()->Root());
+	// Nothing has moved since the last update
+	if (m_dirty_queue.empty())
+	{
+		return;
+	}
+
+	entt::registry& registry = GetScene()->Registry();
+
+	// Dirty nodes start at their own level, nodes outside the levels are queued again once inserted
+	for (entt::entity id : m_dirty_queue)
+	{
+		TransformComponent* transform = registry.valid(id) ? registry.try_get<TransformComponent>(id) : nullptr;
+		if (!transform || !transform->m_queued)
+		{
+			continue;
+		}
+
+		if (transform->m_graph_slot == INVALID_GRAPH_SLOT)
+		{
+			transform->m_queued = false;
+			continue;
+		}
+
+		if (transform->m_graph_depth >= m_dirty_levels.size())
+		{
+			m_dirty_levels.resize(transform->m_graph_depth + 1);
+		}
+
+		m_dirty_levels[transform->m_graph_depth].push_back(transform);
+	}
+
+	m_dirty_queue.clear();
+
+	// Updated transforms are marked changed once their flags are cleared
+	Scene* scene = GetScene();
+	const bool track_changes = scene->IsTracked<TransformComponent>();
+	m_changed.clear();
+
+	// Nodes in a level only read the previous level, so each level is updated in parallel.
+	// Only dirty nodes and their subtrees are visited, so the cost scales with what moved.
+	for (uint32_t depth = 0; depth < m_dirty_levels.size(); depth++)
+	{
+		std::vector<TransformComponent*>& dirty = m_dirty_levels[depth];
+		if (dirty.empty())
+		{
+			continue;
+		}
+
+		ForEachBatch(dirty, [&](TransformComponent** begin, TransformComponent** end)
+		{
+			for (TransformComponent** node = begin; node != end; node++)
+			{
+				TransformComponent& transform = **node;
+				const uint32_t parent_slot = m_levels[depth][transform.m_graph_slot].parent;
+				if (parent_slot == INVALID_GRAPH_SLOT)
+				{
+					transform.UpdateModelMatrix();
+				}
+				else
+				{
+					transform.UpdateModelMatrix(m_levels[depth - 1][parent_slot].transform->model_matrix);
+				}
+			}
+		});
+
+		// Children of a recomputed node are recomputed a level below
+		for (TransformComponent* transform : dirty)
+		{
+			for (Entity child = transform->first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
+			{
+				TransformComponent& child_transform = child.GetComponent<TransformComponent>();
+				if (child_transform.m_queued || child_transform.m_graph_slot == INVALID_GRAPH_SLOT)
+				{
+					continue;
+				}
+
+				if (depth + 1 >= m_dirty_levels.size())
+				{
+					m_dirty_levels.resize(depth + 2);
+				}
+
+				child_transform.m_queued = true;
+				m_dirty_levels[depth + 1].push_back(&child_transform);
+			}
+
+			if (track_changes)
+			{
+				m_changed.push_back(transform->self);
+			}
+
+			transform->m_dirty = false;
+			transform->m_queued = false;
+			transform->m_child_dirty = false;
+
+			// Ancestors only led to this node, a clean one was cleared by an earlier node
+			for (Entity node = transform->parent; node; )
+			{
+				TransformComponent& node_transform = node.GetComponent<TransformComponent>();
+				if (!node_transform.m_child_dirty)
+				{
+					break;
+				}
+
+				node_transform.m_child_dirty = false;
+				node = node_transform.parent;
+			}
+		}
+
+		dirty.clear();
+	}
+
+	if (!m_changed.empty())
+	{
+		scene->MarkChanged<TransformComponent>(m_changed);
+	}
+}
+
+void SceneGraph::QueueDirty(Entity node)
+{
+	m_dirty_queue.push_back(node);
 }
 
 void SceneGraph::OnComponentCreated(Entity e, TransformComponent* transform)
 {
 	// Define self
 	e.GetComponent<TransformComponent>().self = e;
+	e.GetComponent<TransformComponent>().m_scene_graph = this;
 }
 
 void SceneGraph::OnComponentDestroyed(Entity e, TransformComponent* transform)
@@ -36,36 +195,127 @@ void SceneGraph::OnComponentDestroyed(Entity e, TransformComponent* transform)
 		parent.GetComponent<TransformComponent>().RemoveChild(e);
 	}
 
-	// Destroy children immediately
-	for (uint32_t i = 0; i < e.GetComponent<TransformComponent>().children_count; i++)
+	// Destroy children immediately, each child unlinks itself from the list
+	while (Entity child = e.GetComponent<TransformComponent>().first_child)
 	{
-		GetScene()->Destroy(e.GetComponent<TransformComponent>().children[i]);
+		GetScene()->Destroy(child);
+	}
+
+	// Orphans are not part of the levels
+	if (transform->m_graph_slot != INVALID_GRAPH_SLOT)
+	{
+		RemoveSubtree(*transform);
 	}
 
 	e.GetComponent<TransformComponent>().self = {};
+	e.GetComponent<TransformComponent>().m_scene_graph = nullptr;
+}
+
+void SceneGraph::OnParentChanged(TransformComponent& node)
+{
+	if (node.m_graph_slot != INVALID_GRAPH_SLOT)
+	{
+		RemoveSubtree(node);
+	}
+
+	// Subtrees parented to orphans stay out of the levels
+	if (node.parent && node.parent.GetComponent<TransformComponent>().m_graph_slot != INVALID_GRAPH_SLOT)
+	{
+		InsertSubtree(node);
+	}
+}
+
+void SceneGraph::InsertSubtree(TransformComponent& node)
+{
+	m_subtree.clear();
+	m_subtree.push_back(&node);
+
+	// Breadth first so parents have slots before their children
+	for (size_t i = 0; i < m_subtree.size(); i++)
+	{
+		TransformComponent& transform = *m_subtree[i];
+
+		uint32_t depth = 0;
+		uint32_t parent_slot = INVALID_GRAPH_SLOT;
+		if (transform.parent)
+		{
+			const TransformComponent& parent = transform.parent.GetComponent<TransformComponent>();
+			depth = parent.m_graph_depth + 1;
+			parent_slot = parent.m_graph_slot;
+		}
+
+		if (depth >= m_levels.size())
+		{
+			m_levels.resize(depth + 1);
+		}
+
+		transform.m_graph_depth = depth;
+		transform.m_graph_slot = static_cast<uint32_t>(m_levels[depth].size());
+		m_levels[depth].push_back({ &transform, parent_slot });
+
+		// Inserted subtrees must be recomputed against their new parents
+		transform.m_dirty = true;
+
+		for (Entity child = transform.first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
+		{
+			m_subtree.push_back(&child.GetComponent<TransformComponent>());
+		}
+	}
+
+	node.MarkDirty();
 }
 
-void SceneGraph::RecursiveUpdate(TransformComponent& node)
+void SceneGraph::RemoveSubtree(TransformComponent& node)
 {
-	for (uint32_t i = 0; i < node.children_count; i++)
+	m_subtree.clear();
+	m_subtree.push_back(&node);
+
+	for (size_t i = 0; i < m_subtree.size(); i++)
 	{
-		TransformComponent& transform = node.children[i].GetComponent<TransformComponent>();
+		for (Entity child = m_subtree[i]->first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
+		{
+			TransformComponent& child_transform = child.GetComponent<TransformComponent>();
+			if (child_transform.m_graph_slot != INVALID_GRAPH_SLOT)
+			{
+				m_subtree.push_back(&child_transform);
+			}
+		}
+	}
 
-		// TODO: Dirty Check
-		transform.UpdateModelMatrix();
-		
-		RecursiveUpdate(transform);
+	for (TransformComponent* transform : m_subtree)
+	{
+		RemoveNode(*transform);
+	}
+
+	while (!m_levels.empty() && m_levels.back().empty())
+	{
+		m_levels.pop_back();
 	}
 }
 
-void SceneGraph::RecursiveUpdate(Entity e)
+void SceneGraph::RemoveNode(TransformComponent& node)
 {
-	for (uint32_t i = 0; i < e.GetComponent<TransformComponent>().children_count; i++)
+	std::vector<Node>& level = m_levels[node.m_graph_depth];
+	uint32_t slot = node.m_graph_slot;
+
+	// Swap back into the hole and point the moved node's children at its new slot
+	if (slot != level.size() - 1)
 	{
-		TransformComponent& transform = e.GetComponent<TransformComponent>().children[i].GetComponent<TransformComponent>();
+		level[slot] = level.back();
 
-		// TODO: Dirty Check
-		transform.UpdateModelMatrix();
-		RecursiveUpdate(e.GetComponent<TransformComponent>().children[i]);
+		TransformComponent& moved = *level[slot].transform;
+		moved.m_graph_slot = slot;
+
+		for (Entity child = moved.first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
+		{
+			const TransformComponent& child_transform = child.GetComponent<TransformComponent>();
+			if (child_transform.m_graph_slot != INVALID_GRAPH_SLOT)
+			{
+				m_levels[child_transform.m_graph_depth][child_transform.m_graph_slot].parent = slot;
+			}
+		}
 	}
+
+	level.pop_back();
+	node.m_graph_slot = INVALID_GRAPH_SLOT;
 }
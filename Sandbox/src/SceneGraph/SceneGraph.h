@@ -17,10 +17,48 @@ public:
     virtual void OnInit() override;
     virtual void OnShutdown() override;
     virtual void OnUpdate(float dt) override;
+    virtual TaskAccess Access() const override { return TaskAccess().Write<TransformComponent>(); }
 
     virtual void OnComponentCreated(Entity e, TransformComponent* component) override;
     virtual void OnComponentDestroyed(Entity e, TransformComponent* component) override;
+
+    // Number of levels in the hierarchy, the root is level 0
+    uint32_t Depth() const { return static_cast<uint32_t>(m_levels.size()); }
 private:
-    void RecursiveUpdate(TransformComponent& node);
-    void RecursiveUpdate(Entity e);
-};
\ No newline at end of file
+    friend struct TransformComponent;
+
+    // Called by transforms after they are parented or unparented
+    void OnParentChanged(TransformComponent& node);
+
+    // Called by transforms the first time they are marked dirty since the last update
+    void QueueDirty(Entity node);
+
+    // Adds node and its subtree at the level below its parent
+    void InsertSubtree(TransformComponent& node);
+
+    // Removes node and its subtree from the levels
+    void RemoveSubtree(TransformComponent& node);
+    void RemoveNode(TransformComponent& node);
+public:
+    struct Node
+    {
+        TransformComponent* transform;
+        uint32_t parent; // Slot of the parent in the previous level
+    };
+
+private:
+    // Breadth first levels of the hierarchy, parents are always a level before their children
+    std::vector<std::vector<Node>> m_levels;
+
+    // Transforms marked dirty since the last update, by id as they may be destroyed before it
+    std::vector<entt::entity> m_dirty_queue;
+
+    // Transforms to recompute by level during an update, dirty nodes and the subtrees below them
+    std::vector<std::vector<TransformComponent*>> m_dirty_levels;
+
+    // Recomputed transforms of an update, reported to change tracking at once
+    std::vector<entt::entity> m_changed;
+
+    // Scratch queue for subtree walks
+    std::vector<TransformComponent*> m_subtree;
+};
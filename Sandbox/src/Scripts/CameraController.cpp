@@ -23,7 +23,7 @@ void CameraControllerComponent::OnStart()
 
 void CameraControllerComponent::OnUpdate(float dt)
 {
-	Ref<yoyo::Camera> camera = GetComponent<CameraComponent>().camera;
+	yoyo::Camera* camera = GetComponent<CameraComponent>().camera.Get();
 	if (follow && follow_target)
 	{
 		yoyo::Vec3 new_position = follow_target.GetComponent<TransformComponent>().position + follow_offset;
@@ -47,42 +47,48 @@ void CameraControllerComponent::OnUpdate(float dt)
 		FreeControlls(dt);
 	}
 
-	camera->pitch = pitch;
-	camera->yaw = yaw;
+	// The camera subsystem only updates patched or moved cameras
+	if (camera->pitch != pitch || camera->yaw != yaw)
+	{
+		GetScene()->Patch<CameraComponent>(GameObject(), [this](CameraComponent& component) {
+			component.camera->pitch = pitch;
+			component.camera->yaw = yaw;
+		});
+	}
 }
 
 void CameraControllerComponent::FreeControlls(float dt) 
 {
 	auto& transform = GetComponent<TransformComponent>();
-	Ref<yoyo::Camera>& camera = GetComponent<CameraComponent>().camera;
+	yoyo::Camera* camera = GetComponent<CameraComponent>().camera.Get();
 
 	if (yoyo::Input::GetKey(yoyo::KeyCode::Key_w))
 	{
-		transform.position += camera->Front() * m_movement_speed * dt;
+		transform.SetPosition(transform.position + camera->Front() * m_movement_speed * dt);
 	}
 
 	if (yoyo::Input::GetKey(yoyo::KeyCode::Key_s))
 	{
-		transform.position -= camera->Front() * m_movement_speed * dt;
+		transform.SetPosition(transform.position - camera->Front() * m_movement_speed * dt);
 	}
 
 	if (yoyo::Input::GetKey(yoyo::KeyCode::Key_d))
 	{
-		transform.position += camera->Right() * m_movement_speed * dt;
+		transform.SetPosition(transform.position + camera->Right() * m_movement_speed * dt);
 	}
 
 	if (yoyo::Input::GetKey(yoyo::KeyCode::Key_a))
 	{
-		transform.position -= camera->Right() * m_movement_speed * dt;
+		transform.SetPosition(transform.position - camera->Right() * m_movement_speed * dt);
 	}
 
 	if (yoyo::Input::GetKey(yoyo::KeyCode::Key_Space))
 	{
-		transform.position += yoyo::Vec3{ 0.0f, 1.0f, 0.0f } *m_movement_speed * dt;
+		transform.SetPosition(transform.position + yoyo::Vec3{ 0.0f, 1.0f, 0.0f } *m_movement_speed * dt);
 	}
 
 	if (yoyo::Input::GetKey(yoyo::KeyCode::Key_q))
 	{
-		transform.position -= yoyo::Vec3{ 0.0f, 1.0f, 0.0f } *m_movement_speed * dt;
+		transform.SetPosition(transform.position - yoyo::Vec3{ 0.0f, 1.0f, 0.0f } *m_movement_speed * dt);
 	}
 }
@@ -17,7 +17,7 @@ void Enemy::OnStart()
 	YASSERT(HasComponent<Unit>(), "Enemy must have unit component!");
 	YASSERT(HasComponent<UnitController>(), "Enemy must have unit component!");
 
-	m_target = FindEntityWithComponent<VillagerComponent>();
+	m_target = GetScene()->Singleton<PlayerComponent>();
 }
 
 void Enemy::OnUpdate(float dt) 
@@ -15,6 +15,15 @@
 #include "Scripts/Villager.h"
 #include "Scripts/Effect.h"
 
+// Script state is part of scene snapshots, running processes are not.
+// Scripts of disabled entities are partitioned out of their update, scripts are never packed as processes hold on to them.
+template<typename T>
+static void RegisterScript(Scene* scene)
+{
+	scene->RegisterSnapshotComponent<T>();
+	scene->Partition<T>();
+}
+
 void ScriptingSystem::OnInit()
 {
 	yoyo::EventManager::Instance().Subscribe(ScriptCreatedEvent::s_event_type, [&](Ref<yoyo::Event> event) {
@@ -34,30 +43,50 @@ void ScriptingSystem::OnInit()
 		OnCollisionCallback(col_event->collision);
 		return false;
 	});
+
+	GetScene()->OnAcquireBatch().connect<&ScriptingSystem::OnAcquireBatch>(this);
+
+	Scene* scene = GetScene();
+	RegisterScript<CameraControllerComponent>(scene);
+	RegisterScript<Enemy>(scene);
+	RegisterScript<Projectile>(scene);
+	RegisterScript<SunComponent>(scene);
+	RegisterScript<Turret>(scene);
+	RegisterScript<Unit>(scene);
+	RegisterScript<UnitController>(scene);
+	RegisterScript<VillageManagerComponent>(scene);
+	RegisterScript<VillagerComponent>(scene);
+	RegisterScript<Effect>(scene);
+
+	// Looked up by scripts when they start
+	scene->RegisterSingleton<CameraControllerComponent>();
+	scene->RegisterSingleton<PlayerComponent>();
+	scene->RegisterSingleton<SunComponent>();
+}
+
+void ScriptingSystem::OnShutdown()
+{
+	GetScene()->OnAcquireBatch().disconnect<&ScriptingSystem::OnAcquireBatch>(this);
 }
-void ScriptingSystem::OnShutdown() {}
 
 template<typename T>
 void UpdateScript(Scene* scene, float dt)
 {
-	for (auto entity : scene->Registry().group<T>())
+	scene->Each<T>([dt](T& script)
 	{
-		Entity e(entity, scene);
-		T& script = e.GetComponent<T>();
-
-		if (!e.GetComponent<T>().IsActive())
+		if (!script.IsActive())
 		{
-			continue;
+			return;
 		}
 
 		if (!script.started)
 		{
-			e.GetComponent<T>().OnStart();
-			e.GetComponent<T>().started = true;
+			script.OnStart();
+			script.started = true;
 		}
 
-		e.GetComponent<T>().OnUpdate(dt);
-	}
+		script.OnUpdate(dt);
+	});
 }
 
 void ScriptingSystem::OnUpdate(float dt)
@@ -130,6 +159,43 @@ void ScriptingSystem::OnCollisionCallback(psx::Collision& col)
 	ProcessScriptCollision<VillagerComponent>(col, e1, e2);
 }
 
+template<typename T>
+ScriptableEntity* TryGetScript(Scene* scene, entt::entity id)
+{
+	return scene->Registry().try_get<T>(id);
+}
+
+void ScriptingSystem::OnAcquireBatch(const std::vector<entt::entity>& entities)
+{
+	Scene* scene = GetScene();
+
+	for (entt::entity id : entities)
+	{
+		ResetScript(TryGetScript<CameraControllerComponent>(scene, id));
+		ResetScript(TryGetScript<Enemy>(scene, id));
+		ResetScript(TryGetScript<Projectile>(scene, id));
+		ResetScript(TryGetScript<SunComponent>(scene, id));
+		ResetScript(TryGetScript<Turret>(scene, id));
+		ResetScript(TryGetScript<Unit>(scene, id));
+		ResetScript(TryGetScript<UnitController>(scene, id));
+		ResetScript(TryGetScript<VillageManagerComponent>(scene, id));
+		ResetScript(TryGetScript<VillagerComponent>(scene, id));
+		ResetScript(TryGetScript<Effect>(scene, id));
+	}
+}
+
+void ScriptingSystem::ResetScript(ScriptableEntity* script)
+{
+	if (!script)
+	{
+		return;
+	}
+
+	script->started = false;
+	script->m_to_destroy = false;
+	script->ToggleActive(true);
+}
+
 void ScriptingSystem::AttachProcess(Ref<Process> process)
 {
 	YASSERT(process != nullptr, "Process is null");
@@ -44,6 +44,11 @@ public:
     void OnScriptDestroyedCallback(ScriptableEntity* script);
 private:
     void OnCollisionCallback(psx::Collision& col);
+
+    // Scripts of reused pool instances start again, scripts of entities that are merely re-enabled resume
+    void OnAcquireBatch(const std::vector<entt::entity>& entities);
+    void ResetScript(ScriptableEntity* script);
+
     psx::PhysicsWorld* m_physics_world;
 public:
     // Processes
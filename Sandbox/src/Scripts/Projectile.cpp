@@ -12,6 +12,9 @@ Projectile::~Projectile()
 void Projectile::OnStart() 
 {
 	m_life_time = 1.0f;
+
+	// Pooled projectiles start again when reused
+	m_time_elapsed = 0.0f;
 }
 
 void Projectile::OnUpdate(float dt) {
@@ -33,13 +33,13 @@ Entity ScriptableEntity::GameObject()
 	return m_entity;
 }
 
-Entity ScriptableEntity::Instantiate(const std::string& name, const yoyo::Vec3& position)
+Entity ScriptableEntity::Instantiate(Tag name, const yoyo::Vec3& position)
 {
 	auto e = m_entity.m_scene->Instantiate(name, position);
 	return e;
 }
 
-Entity ScriptableEntity::Instantiate(const std::string& name, const yoyo::Mat4x4& transform)
+Entity ScriptableEntity::Instantiate(Tag name, const yoyo::Mat4x4& transform)
 {
 	auto e = m_entity.m_scene->Instantiate(name, transform);
 	return e;
@@ -46,8 +46,11 @@ public:
     T& GetComponent() { return m_entity.GetComponent<T>(); }
 
     // Insantiates new entity
-    Entity Instantiate(const std::string& name = "", const yoyo::Vec3& position = {});
-    Entity Instantiate(const std::string& name, const yoyo::Mat4x4& transform);
+    Entity Instantiate(Tag name = {}, const yoyo::Vec3& position = {});
+    Entity Instantiate(Tag name, const yoyo::Mat4x4& transform);
+
+    // Records structural changes to be applied after scripts have updated
+    SceneCommandBuffer& Commands() { return m_entity.m_scene->CommandBuffer(); }
 
     // Queus an entity for destruction
     void DestroyObject(Entity e);
@@ -70,17 +73,19 @@ public:
     template <typename T>
     Entity FindEntityWithComponent() { return m_entity.m_scene->FindEntityWithComponent<T>(); }
 
+    Entity FindEntityWithTag(Tag tag) { return m_entity.m_scene->FindEntityWithTag(tag); }
+
     template <typename T>
     T* FindComponentInChildren()
     {
         YASSERT(HasComponent<TransformComponent>(), "All entities must have a transform!");
 
         TransformComponent& transform = GetComponent<TransformComponent>();
-        for (int i = 0; i < GetComponent<TransformComponent>().children_count; i++)
+        for (Entity child = transform.first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
         {
-            if (transform.children[i].HasComponent<T>())
+            if (child.HasComponent<T>())
             {
-                return &transform.children[i].GetComponent<T>();
+                return &child.GetComponent<T>();
             }
         }
 
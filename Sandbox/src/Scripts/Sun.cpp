@@ -46,6 +46,7 @@ void SunComponent::OnUpdate(float dt)
 		time -= dt;
 		transform.position.x = yoyo::Lerp(end_position, start_position, (1 - (time / day_duration)));
 	}
+	transform.MarkDirty();
 
 	transform.rotation += yoyo::Normalize(yoyo::Vec3{1.0f, 1.0f, 1.0f}) * dt;
 
@@ -11,8 +11,9 @@ public:
     virtual void OnStart() override;
     virtual void OnUpdate(float dt) override;
 
-	std::vector<yoyo::Vec3> positions = {};
-	std::vector<yoyo::Quat> quaternions = {};
+	// Fixed size so turrets are copied into scene snapshots without allocating
+	std::array<yoyo::Vec3, 12> positions = {};
+	std::array<yoyo::Quat, 12> quaternions = {};
 private:
     float m_time_elapsed = 0.0f;
     float m_attack_rate = 1.0f;
@@ -45,9 +45,9 @@ void AnimateTransformProcess::OnUpdate(float dt)
 		Succeed();
 	}
 	TransformComponent& transform = m_entity.GetComponent<TransformComponent>();
-	transform.position = yoyo::Lerp(start_position, target_position, m_time_elapsed / m_duration);
-	transform.quat_rotation = yoyo::Slerp(start_rotation, target_rotation, m_time_elapsed / m_duration);
-	transform.scale = yoyo::Lerp(start_scale, target_scale, m_time_elapsed / m_duration);
+	transform.SetPosition(yoyo::Lerp(start_position, target_position, m_time_elapsed / m_duration));
+	transform.SetRotation(yoyo::Slerp(start_rotation, target_rotation, m_time_elapsed / m_duration));
+	transform.SetScale(yoyo::Lerp(start_scale, target_scale, m_time_elapsed / m_duration));
 };
 
 Unit::Unit(Entity e)
@@ -110,11 +110,11 @@ void Unit::OnStart()
 	GetComponent<psx::RigidBodyComponent>().SetMaxLinearVelocity(GetComponent<Unit>().GetMovementStats().ms);
 
 	TransformComponent& transform = GetComponent<TransformComponent>();
-	for (int i = 0; i < GetComponent<TransformComponent>().children_count; i++)
+	for (Entity child = transform.first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
 	{
-		if (transform.children[i].HasComponent<MeshRendererComponent>())
+		if (child.HasComponent<MeshRendererComponent>())
 		{
-			m_view = transform.children[i];
+			m_view = child;
 		}
 	}
 	YASSERT(m_view, "Unit as not view [MeshRendere]!");
@@ -164,17 +164,22 @@ void Unit::Die()
 	static auto death_particles_material = yoyo::Material::Create(yoyo::ResourceManager::Instance().Load<yoyo::Material>("default_particle_material"), "death_particles_material");
 	death_particles_material->SetTexture(yoyo::MaterialTextureType::MainTexture, yoyo::ResourceManager::Instance().Load<yoyo::Texture>("white.yo"));
 
-	auto explosion = Instantiate("Death Effect", GetComponent<TransformComponent>().position);
-	explosion.AddComponent<Effect>(explosion);
-	auto& particles = explosion.AddComponent<ParticleSystemComponent>();
-	particles.AddMaterial(death_particles_material);
-	particles.SetLifeTimeRange(3.0f, 8.0f);
-	particles.SetScaleRange(0.1f, 0.8f);
-	particles.SetAngularVelocityRange(yoyo::Vec3{ 0.0f, 0.0f, 2.0f } *-1.0f, yoyo::Vec3{ 0.0f, 0.0f, 2.0f });
-	particles.SetLinearVelocityRange(yoyo::Vec3{ 1.0f, 1.0f, 1.0f } *-5.0f, yoyo::Vec3{ 1.0f, 1.0f, 1.0f } *5.0f);
-	particles.SetGravityScale({ 0.0f, 0.15f, 0.0f });
-	particles.SetExplosiveness(1.0f);
-	particles.SetMaxParticles(32.0f);
+	static const Tag death_effect_tag = "Death Effect";
+
+	SceneCommandBuffer& commands = Commands();
+	DeferredEntity explosion = commands.Instantiate(death_effect_tag, GetComponent<TransformComponent>().position);
+	commands.AddComponent<Effect>(explosion, explosion);
+	commands.AddComponent<ParticleSystemComponent>(explosion);
+	commands.Configure<ParticleSystemComponent>(explosion, [](ParticleSystemComponent& particles) {
+		particles.AddMaterial(death_particles_material);
+		particles.SetLifeTimeRange(3.0f, 8.0f);
+		particles.SetScaleRange(0.1f, 0.8f);
+		particles.SetAngularVelocityRange(yoyo::Vec3{ 0.0f, 0.0f, 2.0f } *-1.0f, yoyo::Vec3{ 0.0f, 0.0f, 2.0f });
+		particles.SetLinearVelocityRange(yoyo::Vec3{ 1.0f, 1.0f, 1.0f } *-5.0f, yoyo::Vec3{ 1.0f, 1.0f, 1.0f } *5.0f);
+		particles.SetGravityScale({ 0.0f, 0.15f, 0.0f });
+		particles.SetExplosiveness(1.0f);
+		particles.SetMaxParticles(32.0f);
+	});
 
 	// Despawn
 	QueueDestroy();
@@ -41,16 +41,16 @@ void UnitController::OnStart()
 	}
 
 	TransformComponent& transform = GetComponent<TransformComponent>();
-	for (int i = 0; i < GetComponent<TransformComponent>().children_count; i++)
+	for (Entity child = transform.first_child; child; child = child.GetComponent<TransformComponent>().next_sibling)
 	{
-		if (transform.children[i].HasComponent<MeshRendererComponent>())
+		if (child.HasComponent<MeshRendererComponent>())
 		{
-			m_view = transform.children[i];
+			m_view = child;
 
 			AnimatorComponent* animator_component;
 			if (m_view.TryGetComponent<AnimatorComponent>(&animator_component))
 			{
-				m_animator = animator_component->animator;
+				m_animator = animator_component->animator.Handle();
 			}
 			else
 			{
@@ -156,39 +156,57 @@ void UnitController::BasicAttack()
 	yoyo::Mat4x4 t_matrix = yoyo::TranslationMat4x4(fire_point) * 
 							yoyo::ScaleMat4x4({0.5f, 0.5f, 0.5f});
 
-	Entity b = Instantiate("Bullet", t_matrix);
-	TransformComponent& b_t = b.GetComponent<TransformComponent>();
-	b_t.quat_rotation = view_transform.quat_rotation;
-	b_t.UpdateModelMatrix();
+	// Interned once instead of on every shot
+	static const Tag bullet_tag = "Bullet";
+	static const Tag explosion_tag = "explosion";
 
-	MeshRendererComponent& mesh_renderer = b.AddComponent<MeshRendererComponent>();
-	mesh_renderer.SetMesh(yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>("Cube"));
-	mesh_renderer.SetMaterial(yoyo::ResourceManager::Instance().Load<yoyo::Material>("grenade_instanced_material"));
+	SceneCommandBuffer& commands = Commands();
+	DeferredEntity b = commands.Instantiate(bullet_tag, t_matrix);
 
-	psx::RigidBodyComponent& rb = b.AddComponent<psx::RigidBodyComponent>();
-	rb.LockRotationAxis({1,1,1});
-	rb.SetUseGravity(false);
+	yoyo::Quat bullet_rotation = view_transform.quat_rotation;
+	commands.Configure<TransformComponent>(b, [bullet_rotation](TransformComponent& b_t) {
+		b_t.SetRotation(bullet_rotation);
+		b_t.UpdateModelMatrix();
+	});
 
-	psx::BoxColliderComponent& col = b.AddComponent<psx::BoxColliderComponent>(yoyo::Vec3{0.5f, 0.5f, 0.5f});
-	b.AddComponent<Projectile>(b);
-	yoyo::Vec3 impulse = b.GetComponent<TransformComponent>().Forward() * bullet_speed;
-	rb.AddForce(impulse, psx::ForceMode::Impulse);
+	commands.AddComponent<MeshRendererComponent>(b);
+	commands.Configure<MeshRendererComponent>(b, [](MeshRendererComponent& mesh_renderer) {
+		mesh_renderer.SetMesh(yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>("Cube"));
+		mesh_renderer.SetMaterial(yoyo::ResourceManager::Instance().Load<yoyo::Material>("grenade_instanced_material"));
+	});
+
+	commands.AddComponent<psx::RigidBodyComponent>(b);
+	commands.Configure<psx::RigidBodyComponent>(b, [](psx::RigidBodyComponent& rb) {
+		rb.LockRotationAxis({1,1,1});
+		rb.SetUseGravity(false);
+	});
+
+	commands.AddComponent<psx::BoxColliderComponent>(b, yoyo::Vec3{0.5f, 0.5f, 0.5f});
+	commands.AddComponent<Projectile>(b, b);
+
+	// Bullet shares the view's rotation
+	yoyo::Vec3 impulse = view_transform.Forward() * bullet_speed;
+	commands.Configure<psx::RigidBodyComponent>(b, [impulse](psx::RigidBodyComponent& rb) {
+		rb.AddForce(impulse, psx::ForceMode::Impulse);
+	});
 
 	// Muzzle flare
 	if(true){
-		auto explosion = Instantiate("explosion");
-		explosion.AddComponent<Effect>(b);
-		auto& particles = explosion.AddComponent<ParticleSystemComponent>();
-		yoyo::Vec3 v = {-10.0f, 0.0f, -10.0f};
-		
-		particles.SetMaxParticles(128);
-		particles.SetExplosiveness(1.0f);
-		particles.SetLifeTimeRange(1.0f, 3.0f);
-		particles.SetLinearVelocityRange(v , v );
-		particles.SetScaleRange(0.15, 1.5f);
-		particles.SetMaxParticles(128);
-		
-		b.GetComponent<TransformComponent>().AddChild(explosion);
+		DeferredEntity explosion = commands.Instantiate(explosion_tag);
+		commands.AddComponent<Effect>(explosion, b);
+		commands.AddComponent<ParticleSystemComponent>(explosion);
+		commands.Configure<ParticleSystemComponent>(explosion, [](ParticleSystemComponent& particles) {
+			yoyo::Vec3 v = {-10.0f, 0.0f, -10.0f};
+
+			particles.SetMaxParticles(128);
+			particles.SetExplosiveness(1.0f);
+			particles.SetLifeTimeRange(1.0f, 3.0f);
+			particles.SetLinearVelocityRange(v , v );
+			particles.SetScaleRange(0.15, 1.5f);
+			particles.SetMaxParticles(128);
+		});
+
+		commands.AddChild(b, explosion);
 	}
 }
 
@@ -196,27 +214,35 @@ void UnitController::AltAttack()
 {
 	//Projectile
 	const auto& transform = GetComponent<TransformComponent>();
-	static const auto& view_transform = m_view.GetComponent<TransformComponent>();
-	const yoyo::Vec3& fire_point = transform.position + (view_transform.Forward() * 3.0f);
+	const auto& view_transform = m_view.GetComponent<TransformComponent>();
+	const yoyo::Vec3 fire_point = transform.position + (view_transform.Forward() * 3.0f);
 
 	float bullet_speed = 20.0f;
-	// yoyo::Mat4x4 transform_matrix = yoyo::TranslationMat4x4(transform.position + view_transform.Forward() * 2.0f) * yoyo::ScaleMat4x4({0.25f, 0.25f, 0.25f});
 	yoyo::Mat4x4 transform_matrix = yoyo::TranslationMat4x4(fire_point) * yoyo::ScaleMat4x4({1.0f, 1.0f, 1.0f});
 
-	Entity bullet = Instantiate("Turret", transform_matrix);
-	MeshRendererComponent& mesh_renderer = bullet.AddComponent<MeshRendererComponent>();
-	mesh_renderer.SetMesh(yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>("Cube"));
-	mesh_renderer.SetMaterial(yoyo::ResourceManager::Instance().Load<yoyo::Material>("grenade_instanced_material"));
+	static const Tag turret_tag = "Turret";
+
+	// Called while scripts iterate, the turret is created at the next sync point
+	SceneCommandBuffer& commands = Commands();
+	DeferredEntity turret = commands.Instantiate(turret_tag, transform_matrix);
+
+	commands.AddComponent<MeshRendererComponent>(turret);
+	commands.Configure<MeshRendererComponent>(turret, [](MeshRendererComponent& mesh_renderer) {
+		mesh_renderer.SetMesh(yoyo::ResourceManager::Instance().Load<yoyo::StaticMesh>("Cube"));
+		mesh_renderer.SetMaterial(yoyo::ResourceManager::Instance().Load<yoyo::Material>("grenade_instanced_material"));
+	});
 
-	psx::RigidBodyComponent& rb = bullet.AddComponent<psx::RigidBodyComponent>();
-	//rb.SetUseGravity(false);
-	rb.LockRotationAxis({0,1,0});
+	commands.AddComponent<psx::RigidBodyComponent>(turret);
+	commands.Configure<psx::RigidBodyComponent>(turret, [](psx::RigidBodyComponent& rb) {
+		rb.LockRotationAxis({0,1,0});
+	});
 
-	//psx::BoxColliderComponent& col = bullet.AddComponent<psx::BoxColliderComponent>(yoyo::Vec3{0.25f, 0.25f, 0.25f});
-	psx::BoxColliderComponent& col = bullet.AddComponent<psx::BoxColliderComponent>();
+	commands.AddComponent<psx::BoxColliderComponent>(turret);
+	commands.AddComponent<Turret>(turret, turret);
 
-	bullet.AddComponent<Turret>(bullet);
 	yoyo::Vec3 impulse = view_transform.Forward() * bullet_speed;
 	impulse.y = 20.0f;
-	rb.AddForce(impulse, psx::ForceMode::Impulse);
+	commands.Configure<psx::RigidBodyComponent>(turret, [impulse](psx::RigidBodyComponent& rb) {
+		rb.AddForce(impulse, psx::ForceMode::Impulse);
+	});
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <Math/Math.h>
 #include "NativeScript.h"
+#include "RenderScene/RenderObjectPool.h"
 
 namespace yoyo
 {
@@ -34,5 +35,5 @@ private:
     Ref<AnimateTransformProcess> m_animate_transform_process;
 private:
     Entity m_view = {};
-    Ref<yoyo::Animator> m_animator = nullptr;
+    RenderHandle<yoyo::Animator> m_animator;
 };
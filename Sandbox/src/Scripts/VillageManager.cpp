@@ -11,6 +11,7 @@
 #include <Renderer/Texture.h>
 #include <Renderer/Animation.h>
 
+#include "ECS/Prefab.h"
 #include "ECS/Components/RenderableComponents.h"
 #include "ParticleSystem/Particles.h"
 
@@ -39,11 +40,7 @@ void VillageManagerComponent::OnUpdate(float dt)
 		if (m_villager_count < props.max_villagers)
 		{
 			SpawnVillager();
-
-			for(int i = 0; i < 5; i++)
-			{
-				SpawnEnemy();
-			}
+			SpawnEnemies(5);
 		}
 
 		m_timer = 0;
@@ -72,131 +69,161 @@ void VillageManagerComponent::TraverseRecursive(const yoyo::SkeletalNode* node,
 	}
 }
 
-void VillageManagerComponent::SpawnVillager(const VillagerProps& props)
+// Adds a child node with a mesh renderer for each skinned mesh of the model
+static std::vector<std::pair<PrefabNode, Ref<yoyo::SkinnedMesh>>> AddSkinnedMeshNodes(Prefab& prefab, PrefabNode root, const Ref<yoyo::Model>& model, const Ref<yoyo::Material>& material)
 {
-	static auto villager_model = yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/Humanoid.yo");
-	static auto skinned_villager_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("skinned_people_material");
-
-	Entity villager = Instantiate("villager", { 0.0f, 0.0f, 0.0f });
-	villager.GetComponent<TransformComponent>().scale *= 0.05f;
-
-	for (int i = 0; i < villager_model->meshes.size(); i++)
+	std::vector<std::pair<PrefabNode, Ref<yoyo::SkinnedMesh>>> nodes;
+	for (int i = 0; i < model->meshes.size(); i++)
 	{
-		yoyo::MeshType mesh_type = villager_model->meshes[i]->GetMeshType();
+		yoyo::MeshType mesh_type = model->meshes[i]->GetMeshType();
 
 		if (mesh_type == yoyo::MeshType::Skinned)
 		{
-			Ref<yoyo::SkinnedMesh> mesh = std::static_pointer_cast<yoyo::SkinnedMesh>(villager_model->meshes[i]);
-			Entity child = Instantiate(mesh->name, villager_model->model_matrices[i]);
-			villager.GetComponent<TransformComponent>().AddChild(child);
-
-			auto& mesh_renderer = child.AddComponent<MeshRendererComponent>();
-			mesh_renderer.SetMesh(mesh);
-			mesh_renderer.SetMaterial(skinned_villager_material);
-			mesh_renderer.type = mesh_type;
-
-			// TODO: Fix animator component updating multiple times each component
-			AnimatorComponent& animator = child.AddComponent<AnimatorComponent>();
-			animator.animator->skinned_mesh = mesh;
-			animator.animator->animations.push_back(yoyo::ResourceManager::Instance().Load<yoyo::Animation>("assets/animations/VillagerRunning.yanimation"));
-			animator.animator->animations.push_back(yoyo::ResourceManager::Instance().Load<yoyo::Animation>("assets/animations/HipHopDancing.yanimation"));
+			Ref<yoyo::SkinnedMesh> mesh = std::static_pointer_cast<yoyo::SkinnedMesh>(model->meshes[i]);
+			PrefabNode child = prefab.AddNode(mesh->name, model->model_matrices[i], root);
+
+			// Crowds are mostly drawn far away, the levels are generated by CapitalPunishmentMeshLod
+			Ref<MeshLodChain> lods = LoadMeshLods(mesh);
+
+			prefab.AddComponent<MeshRendererComponent>(child);
+			prefab.Configure<MeshRendererComponent>(child, [mesh, lods, material, mesh_type](MeshRendererComponent& mesh_renderer) {
+				mesh_renderer.SetMesh(mesh);
+				mesh_renderer.lods = lods;
+				mesh_renderer.SetMaterial(material);
+				mesh_renderer.type = mesh_type;
+			});
+
+			nodes.push_back({ child, mesh });
 		}
 	}
 
-	villager.AddComponent<psx::RigidBodyComponent>().LockRotationAxis({1,0,1});
-	villager.AddComponent<psx::BoxColliderComponent>();
-
-	// Dust
+	return nodes;
+}
 
-	villager.AddComponent<Unit>(villager);
-	villager.AddComponent<UnitController>(villager);
-	villager.AddComponent<VillagerComponent>(villager);
-	m_villager_count++;
+static void AddAnimator(Prefab& prefab, PrefabNode node, Ref<yoyo::SkinnedMesh> mesh, const std::vector<Ref<yoyo::Animation>>& animations)
+{
+	prefab.AddComponent<AnimatorComponent>(node);
+	prefab.Configure<AnimatorComponent>(node, [mesh, animations](AnimatorComponent& animator) {
+		animator.animator->skinned_mesh = mesh;
+		animator.animator->animations.insert(animator.animator->animations.end(), animations.begin(), animations.end());
+	});
 }
 
-void VillageManagerComponent::SpawnEnemy() 
+static Prefab CreateVillagerPrefab(bool player)
 {
-	static auto villager_model = yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/Humanoid.yo");
-	static auto skinned_villager_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("skinned_people_material");
+	auto villager_model = yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/Humanoid.yo");
+	auto skinned_villager_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("skinned_people_material");
 
-	auto villager = Instantiate("enemy_villager", { pos_generator.Next(), 0.0f, pos_generator.Next() });
-	villager.GetComponent<TransformComponent>().scale *= 0.05f;
+	std::vector<Ref<yoyo::Animation>> animations;
+	animations.push_back(yoyo::ResourceManager::Instance().Load<yoyo::Animation>("assets/animations/VillagerRunning.yanimation"));
+	animations.push_back(yoyo::ResourceManager::Instance().Load<yoyo::Animation>("assets/animations/HipHopDancing.yanimation"));
 
-	for (int i = 0; i < villager_model->meshes.size(); i++)
-	{
-		yoyo::MeshType mesh_type = villager_model->meshes[i]->GetMeshType();
+	Prefab prefab;
+	PrefabNode villager = prefab.AddNode("villager", yoyo::ScaleMat4x4({ 0.05f, 0.05f, 0.05f }));
 
-		if (mesh_type == yoyo::MeshType::Skinned)
-		{
-			Ref<yoyo::SkinnedMesh> mesh = std::static_pointer_cast<yoyo::SkinnedMesh>(villager_model->meshes[i]);
-
-			Entity child = Instantiate(mesh->name, villager_model->model_matrices[i]);
-			villager.GetComponent<TransformComponent>().AddChild(child);
-
-			auto& mesh_renderer = child.AddComponent<MeshRendererComponent>();
-			mesh_renderer.SetMesh(mesh);
-			mesh_renderer.SetMaterial(skinned_villager_material);
-			mesh_renderer.type = mesh_type;
-			// TODO: Fix animator component updating multiple times each component
-			// AnimatorComponent& animator = child.AddComponent<AnimatorComponent>();
-			// animator.animator->skinned_mesh = mesh;
-			// animator.animator->animations.push_back(yoyo::ResourceManager::Instance().Load<yoyo::Animation>("assets/animations/VillagerRunning.yanimation"));
-			// animator.animator->animations.push_back(yoyo::ResourceManager::Instance().Load<yoyo::Animation>("assets/animations/HipHopDancing.yanimation"));
-		}
+	// TODO: Fix animator component updating multiple times each component
+	for (const auto& [child, mesh] : AddSkinnedMeshNodes(prefab, villager, villager_model, skinned_villager_material))
+	{
+		AddAnimator(prefab, child, mesh, animations);
 	}
 
-	villager.AddComponent<psx::RigidBodyComponent>().LockRotationAxis({1,0,1});
-	villager.AddComponent<psx::BoxColliderComponent>();
+	prefab.AddComponent<psx::RigidBodyComponent>(villager);
+	prefab.Configure<psx::RigidBodyComponent>(villager, [](psx::RigidBodyComponent& rb) { rb.LockRotationAxis({1,0,1}); });
+	prefab.AddComponent<psx::BoxColliderComponent>(villager);
+
+	// Dust
+
+	prefab.AddComponent<Unit>(villager, villager);
+	prefab.AddComponent<UnitController>(villager, villager);
+	prefab.AddComponent<VillagerComponent>(villager, villager);
 
-	villager.AddComponent<Unit>(villager).GetMovementStats().ms *= 0.80f;
-	villager.AddComponent<UnitController>(villager);
-	//villager.AddComponent<Enemy>(villager);
+	if (player)
+	{
+		prefab.AddComponent<PlayerComponent>(villager);
+	}
+
+	return prefab;
 }
 
-void VillageManagerComponent::SpawnMutant()
+static Prefab CreateEnemyPrefab()
 {
-	static auto skinned_debug_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("skinned_colormap_debug_material");
-	static auto skinned_mutant_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("skinned_mutant_material");
+	auto villager_model = yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/Humanoid.yo");
+	auto skinned_villager_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("skinned_people_material");
+
+	Prefab prefab;
+	PrefabNode villager = prefab.AddNode("enemy_villager", yoyo::ScaleMat4x4({ 0.05f, 0.05f, 0.05f }));
+
+	AddSkinnedMeshNodes(prefab, villager, villager_model, skinned_villager_material);
+
+	prefab.AddComponent<psx::RigidBodyComponent>(villager);
+	prefab.Configure<psx::RigidBodyComponent>(villager, [](psx::RigidBodyComponent& rb) { rb.LockRotationAxis({1,0,1}); });
+	prefab.AddComponent<psx::BoxColliderComponent>(villager);
 
-	static auto mutant_model = yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/mutant.yo");
-	auto mutant = Instantiate("mutant", { pos_generator.Next(), height_generator.Next(), pos_generator.Next()});
+	prefab.AddComponent<Unit>(villager, villager);
+	prefab.Configure<Unit>(villager, [](Unit& unit) { unit.GetMovementStats().ms *= 0.80f; });
+	prefab.AddComponent<UnitController>(villager, villager);
+	//prefab.AddComponent<Enemy>(villager, villager);
 
-	TransformComponent& model_transform = mutant.GetComponent<TransformComponent>();
-	model_transform.scale *= 0.1f;
+	return prefab;
+}
+
+static Prefab CreateMutantPrefab()
+{
+	auto skinned_mutant_material = yoyo::ResourceManager::Instance().Load<yoyo::Material>("skinned_mutant_material");
+	auto mutant_model = yoyo::ResourceManager::Instance().Load<yoyo::Model>("assets/models/mutant.yo");
+
+	Prefab prefab;
+	PrefabNode mutant = prefab.AddNode("mutant", yoyo::ScaleMat4x4({ 0.1f, 0.1f, 0.1f }));
 
-	for (int i = 0; i < mutant_model->meshes.size(); i++)
+	// Only the first skinned mesh is animated
+	auto mesh_nodes = AddSkinnedMeshNodes(prefab, mutant, mutant_model, skinned_mutant_material);
+	if (!mesh_nodes.empty())
 	{
-		yoyo::MeshType mesh_type = mutant_model->meshes[i]->GetMeshType();
+		AddAnimator(prefab, mesh_nodes.front().first, mesh_nodes.front().second, { yoyo::ResourceManager::Instance().Load<yoyo::Animation>("slash") });
+	}
 
-		if (mesh_type == yoyo::MeshType::Skinned)
-		{
-			Ref<yoyo::SkinnedMesh> mesh = std::static_pointer_cast<yoyo::SkinnedMesh>(mutant_model->meshes[i]);
+	prefab.AddComponent<psx::RigidBodyComponent>(mutant);
+	prefab.Configure<psx::RigidBodyComponent>(mutant, [](psx::RigidBodyComponent& rb) { rb.LockRotationAxis({1,1,1}); });
+	prefab.AddComponent<psx::BoxColliderComponent>(mutant, yoyo::Vec3{5.0f, 1.0f, 5.0f});
 
-			Entity child = Instantiate(mesh->name, mutant_model->model_matrices[i]);
-			model_transform.AddChild(child);
+	prefab.AddComponent<Unit>(mutant, mutant);
+	prefab.AddComponent<UnitController>(mutant, mutant);
 
-			{
-				auto& mesh_renderer = child.AddComponent<MeshRendererComponent>();
-				mesh_renderer.SetMesh(mesh);
-				mesh_renderer.SetMaterial(skinned_mutant_material);
-				mesh_renderer.type = mesh_type;
-			}
-
-			static bool do_once = [&]()
-			{
-				AnimatorComponent& animator = child.AddComponent<AnimatorComponent>();
-				animator.animator->skinned_mesh = mesh;
-				animator.animator->animations.push_back(yoyo::ResourceManager::Instance().Load<yoyo::Animation>("slash"));
-				return true;
-			}();
-		}
+	return prefab;
+}
+
+void VillageManagerComponent::SpawnVillager(const VillagerProps& props)
+{
+	static const Prefab player_prefab = CreateVillagerPrefab(true);
+	static const Prefab villager_prefab = CreateVillagerPrefab(false);
+
+	// Spawned while scripts iterate, the instances are created at the next sync point. The first villager is the one enemies chase.
+	Commands().Instantiate(m_villager_count == 0 ? player_prefab : villager_prefab, { props.position });
+	m_villager_count++;
+}
+
+void VillageManagerComponent::SpawnEnemy() 
+{
+	SpawnEnemies(1);
+}
+
+void VillageManagerComponent::SpawnEnemies(uint32_t count)
+{
+	static const Prefab enemy_prefab = CreateEnemyPrefab();
+
+	std::vector<yoyo::Vec3> positions(count);
+	for (yoyo::Vec3& position : positions)
+	{
+		position = { pos_generator.Next(), 0.0f, pos_generator.Next() };
 	}
 
-	psx::RigidBodyComponent& rb = mutant.AddComponent<psx::RigidBodyComponent>();
-	rb.LockRotationAxis({1,1,1});
-	psx::BoxColliderComponent& box_collider = mutant.AddComponent<psx::BoxColliderComponent>(yoyo::Vec3{5.0f, 1.0f, 5.0f});
+	Commands().Instantiate(enemy_prefab, std::move(positions));
+}
 
-	mutant.AddComponent<Unit>(mutant);
-	mutant.AddComponent<UnitController>(mutant);
+void VillageManagerComponent::SpawnMutant()
+{
+	static const Prefab mutant_prefab = CreateMutantPrefab();
+
+	Commands().Instantiate(mutant_prefab, { yoyo::Vec3{ pos_generator.Next(), height_generator.Next(), pos_generator.Next() } });
 	m_villager_count++;
-}
\ No newline at end of file
+}
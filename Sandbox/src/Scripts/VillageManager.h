@@ -10,6 +10,7 @@ struct VillageItem
 struct VillagerProps
 {
     int gender;
+    yoyo::Vec3 position = { 0.0f, 0.0f, 0.0f };
 };
 
 struct VillageProps
@@ -36,6 +37,7 @@ public:
 
     void SpawnVillager(const VillagerProps& props = {});
     void SpawnEnemy();
+    void SpawnEnemies(uint32_t count);
     void SpawnMutant();
 private:
     void TraverseRecursive(const yoyo::SkeletalNode* node, const std::vector<yoyo::SkinnedMeshJoint>& joints, Entity parent);
@@ -24,7 +24,7 @@ void VillagerComponent::OnCreate() {}
 
 void VillagerComponent::OnStart()
 {
-	m_game_camera = FindEntityWithComponent<CameraControllerComponent>();
+	m_game_camera = GetScene()->Singleton<CameraControllerComponent>();
 
 	if (!m_game_camera.IsValid())
 	{
@@ -55,7 +55,7 @@ void VillagerComponent::OnUpdate(float dt)
 	{
 		{
 			yoyo::IVec2 mouse_pos = yoyo::Input::GetMousePosition();
-			const Ref<yoyo::Camera>& camera = m_game_camera.GetComponent<CameraComponent>().camera;
+			yoyo::Camera* camera = m_game_camera.GetComponent<CameraComponent>().camera.Get();
 
 			float x = (2.0f * mouse_pos.x) / 1920.0f - 1.0f;
 			float y = 1.0f - (2.0f * mouse_pos.y) / 1080.0f;
@@ -2,6 +2,11 @@
 
 #include "NativeScript.h"
 
+// Marks the villager enemies chase, only the first villager spawned by the village holds it so it is looked up through Scene::Singleton
+struct PlayerComponent
+{
+};
+
 class VillagerComponent : public ScriptableEntity
 {
 public:
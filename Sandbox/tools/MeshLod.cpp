@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Assets/MeshFile.h"
+#include "Assets/MeshSimplify.h"
+
+// Writes simplified levels of .ymesh files next to them, i.e. MutantMesh.ymesh -> MutantMesh_lod1.ymesh, MutantMesh_lod2.ymesh, ...
+// Levels only keep the vertices they use and record the source vertex of each, which skinned meshes need to find their model's bone weights.
+
+static void PrintUsage()
+{
+	printf("usage: CapitalPunishmentMeshLod [--ratios r1,r2,...] mesh.ymesh...\n");
+	printf("  --ratios  triangles kept by each level relative to the source mesh, default 0.5,0.2,0.08\n");
+}
+
+static bool ParseRatios(const char* value, std::vector<float>& ratios)
+{
+	ratios.clear();
+
+	const char* text = value;
+	while (*text)
+	{
+		char* end = nullptr;
+		float ratio = strtof(text, &end);
+		if (end == text || ratio <= 0.0f || ratio >= 1.0f)
+		{
+			return false;
+		}
+
+		ratios.push_back(ratio);
+		text = *end == ',' ? end + 1 : end;
+		if (*end && *end != ',')
+		{
+			return false;
+		}
+	}
+
+	return !ratios.empty();
+}
+
+static bool GenerateLods(const std::string& path, const std::vector<float>& ratios)
+{
+	MeshFile source;
+	if (!ReadMeshFile(path, source))
+	{
+		fprintf(stderr, "Failed to read mesh %s\n", path.c_str());
+		return false;
+	}
+
+	const size_t source_triangles = source.indices.size() / 3;
+	printf("%s: %zu vertices, %zu triangles\n", path.c_str(), source.vertices.size(), source_triangles);
+
+	MeshFile lod = source;
+	for (uint32_t level = 1; level <= ratios.size(); level++)
+	{
+		std::vector<uint32_t> indices = SimplifyIndices(source.vertices, source.indices, ratios[level - 1]);
+
+		// Levels that drop nothing over the previous one are not worth a file
+		if (indices.empty() || indices.size() >= lod.indices.size())
+		{
+			printf("  lod %u: no further simplification, stopping\n", level);
+			break;
+		}
+
+		lod.lod = level;
+		lod.indices = std::move(indices);
+		lod.source_vertices = CompactVertices(source.vertices, lod.indices, lod.vertices);
+		lod.source_vertex_count = static_cast<uint32_t>(source.vertices.size());
+
+		const std::string lod_path = MeshLodPath(path, level);
+		if (!WriteMeshFile(lod_path, lod))
+		{
+			fprintf(stderr, "Failed to write mesh %s\n", lod_path.c_str());
+			return false;
+		}
+
+		// Read back so broken files never reach the game
+		MeshFile written;
+		if (!ReadMeshFile(lod_path, written) || written.indices != lod.indices || written.source_vertices != lod.source_vertices || written.vertices.size() != lod.vertices.size())
+		{
+			fprintf(stderr, "Mesh %s did not read back\n", lod_path.c_str());
+			return false;
+		}
+
+		const size_t triangles = lod.indices.size() / 3;
+		printf("  lod %u: %zu vertices, %zu triangles (%.1f%%) -> %s\n", level, lod.vertices.size(), triangles, source_triangles > 0 ? 100.0 * triangles / source_triangles : 0.0, lod_path.c_str());
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<float> ratios = { 0.5f, 0.2f, 0.08f };
+	std::vector<std::string> paths;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--help") == 0)
+		{
+			PrintUsage();
+			return 0;
+		}
+
+		if (strcmp(argv[i], "--ratios") == 0)
+		{
+			if (i + 1 >= argc || !ParseRatios(argv[i + 1], ratios))
+			{
+				fprintf(stderr, "Invalid ratios\n");
+				return 1;
+			}
+
+			i++;
+			continue;
+		}
+
+		paths.push_back(argv[i]);
+	}
+
+	if (paths.empty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	bool succeeded = true;
+	for (const std::string& path : paths)
+	{
+		succeeded = GenerateLods(path, ratios) && succeeded;
+	}
+
+	return succeeded ? 0 : 1;
+}